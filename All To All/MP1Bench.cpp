@@ -0,0 +1,108 @@
+/**********************************
+ * FILE NAME: MP1Bench.cpp
+ *
+ * DESCRIPTION: Microbenchmarks of the hot functions of MP1Node, each run alone on a node whose
+ * 				membership list holds 10 up to 100000 members.
+ * 				Build with make bench, run ./Bench [largest size].
+ **********************************/
+
+#include "MP1Node.h"
+#include "Bench.h"
+
+using namespace alltoall;
+
+/**
+ * FUNCTION NAME: fill
+ *
+ * DESCRIPTION: Put members 2 to size + 1 in the membership list of a node that just started at
+ * 				tick 0
+ */
+template <class Node>
+void fill(Node *node, int size) {
+	Member *member = node->getMemberNode();
+
+	for ( int i = 0; i < size; i++ ) {
+		MemberListEntry entry(i + 2, 0, 1, 0);
+		member->memberList.push_back(entry);
+		node->armRemoval(entry);
+	}
+}
+
+/**
+ * FUNCTION NAME: benchSize
+ *
+ * DESCRIPTION: Run every function at a size on a node of the given policy
+ */
+template <class Policy>
+void benchSize(Bench &bench, Params *par, EmulNet *en, Log *log, Address &self, int size) {
+	typedef MP1Node<Policy> Node;
+	Member *member = new Member();
+	Node *node = new Node(member, par, en, log, &self);
+	par->globaltime = 0;
+	node->initThisNode(&self);
+	fill(node, size);
+
+	// A heartbeat carrying the whole list, news to none of its entries
+	size_t msgsize;
+	MessageHdr *msg = node->joinRep(&msgsize);
+	msg->msgType = HBEAT;
+	if ( size <= BENCH_QUADRATIC_MAX ) {
+		bench.run("recvCallBack/HBEAT", size, [&]() {
+			node->recvCallBack(member, (char *)msg, msgsize);
+		});
+	}
+	else {
+		bench.skip("recvCallBack/HBEAT", size);
+	}
+	free(msg);
+
+	// The heartbeats of a tick at which no removal is due, the whole list to every member,
+	// built and dropped by EmulNet
+	if ( size <= BENCH_QUADRATIC_MAX ) {
+		bench.run("nodeLoopOps", size, [&]() {
+			node->nodeLoopOps();
+		});
+	}
+	else {
+		bench.skip("nodeLoopOps", size);
+	}
+
+	bench.run("joinRep", size, [&]() {
+		size_t msgsize;
+		free(node->joinRep(&msgsize));
+	});
+
+	delete node;
+	delete member;
+}
+
+/**********************************
+ * FUNCTION NAME: main
+ *
+ * DESCRIPTION: Run every function at every size, on a node of the constants of the build and
+ * 				on one of the RuntimePolicy, whose lines end in /runtime
+ **********************************/
+int main(int argc, char *argv[]) {
+	int largest = argc > 1 ? atoi(argv[1]) : 100000;
+	Params *par = Bench::params();
+	Log *log = new Log(par);
+	EmulNet *en = new EmulNet(par);
+	Address self("1:0");
+	Bench bench;
+
+	// Every message sent is dropped, so that the network does not fill up over the calls
+	par->dropmsg = 1;
+	par->MSG_DROP_PROB = 1;
+
+	for ( int size: Bench::sizes(largest) ) {
+		bench.variant("");
+		benchSize<BuiltPolicy>(bench, par, en, log, self, size);
+		bench.variant("/runtime");
+		benchSize<RuntimePolicy>(bench, par, en, log, self, size);
+	}
+
+	delete en;
+	delete log;
+	delete par;
+	return SUCCESS;
+}
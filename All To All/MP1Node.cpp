@@ -11,12 +11,15 @@
  * Note: You can change/add any functions in MP1Node.{h,cpp}
  */
 
+namespace alltoall {
+
 /**
  * Overloaded Constructor of the MP1Node class
  * You can add new members to the class if you think it
  * is necessary for your logic to work
  */
-MP1Node::MP1Node(Member *member, Params *params, EmulNet *emul, Log *log, Address *address) {
+template <class Policy>
+MP1Node<Policy>::MP1Node(Member *member, Params *params, EmulNet *emul, Log *log, Address *address): policy(params) {
 	for( int i = 0; i < 6; i++ ) {
 		NULLADDR[i] = 0;
 	}
@@ -25,12 +28,14 @@ MP1Node::MP1Node(Member *member, Params *params, EmulNet *emul, Log *log, Addres
 	this->log = log;
 	this->par = params;
 	this->memberNode->addr = *address;
+	this->lastLoop = 0;
 }
 
 /**
  * Destructor of the MP1Node class
  */
-MP1Node::~MP1Node() {}
+template <class Policy>
+MP1Node<Policy>::~MP1Node() {}
 
 /**
  * FUNCTION NAME: recvLoop
@@ -38,7 +43,8 @@ MP1Node::~MP1Node() {}
  * DESCRIPTION: This function receives message from the network and pushes into the queue
  * 				This function is called by a node to receive messages currently waiting for it
  */
-int MP1Node::recvLoop() {
+template <class Policy>
+int MP1Node<Policy>::recvLoop() {
     if ( memberNode->bFailed ) {
     	return false;
     }
@@ -52,9 +58,10 @@ int MP1Node::recvLoop() {
  *
  * DESCRIPTION: Enqueue the message from Emulnet into the queue
  */
-int MP1Node::enqueueWrapper(void *env, char *buff, int size) {
+template <class Policy>
+int MP1Node<Policy>::enqueueWrapper(void *env, char *buff, int size) {
 	Queue q;
-	return q.enqueue((queue<q_elt> *)env, (void *)buff, size);
+	return q.enqueue((MessageQueue *)env, (void *)buff, size);
 }
 
 /**
@@ -64,7 +71,8 @@ int MP1Node::enqueueWrapper(void *env, char *buff, int size) {
  * 				All initializations routines for a member.
  * 				Called by the application layer.
  */
-void MP1Node::nodeStart(char *servaddrstr, short servport) {
+template <class Policy>
+void MP1Node<Policy>::nodeStart(char *servaddrstr, short servport) {
     Address joinaddr;
     joinaddr = getJoinAddress();
 
@@ -92,12 +100,11 @@ void MP1Node::nodeStart(char *servaddrstr, short servport) {
  *
  * DESCRIPTION: Find out who I am and start up
  */
-int MP1Node::initThisNode(Address *joinaddr) {
+template <class Policy>
+int MP1Node<Policy>::initThisNode(Address *joinaddr) {
 	/*
 	 * This function is partially implemented and may require changes
 	 */
-	int id = *(int*)(&memberNode->addr.addr);
-	int port = *(short*)(&memberNode->addr.addr[4]);
 
 	memberNode->bFailed = false;
 	memberNode->inited = true;
@@ -105,9 +112,11 @@ int MP1Node::initThisNode(Address *joinaddr) {
     // node is up!
 	memberNode->nnb = 0;
 	memberNode->heartbeat = 0;
-	memberNode->pingCounter = TFAIL;
+	memberNode->pingCounter = policy.tfail;
 	memberNode->timeOutCounter = -1;
+    lastLoop = par->getcurrtime();
     initMemberListTable(memberNode);
+    expiry.reset(par->getcurrtime());
 
     return 0;
 }
@@ -117,10 +126,11 @@ int MP1Node::initThisNode(Address *joinaddr) {
  *
  * DESCRIPTION: Join the distributed system
  */
-int MP1Node::introduceSelfToGroup(Address *joinaddr) {
+template <class Policy>
+int MP1Node<Policy>::introduceSelfToGroup(Address *joinaddr) {
     MessageHdr *msg;
 #ifdef DEBUGLOG
-    static char s[1024];
+    char s[1024];
 #endif
 
     if ( 0 == memcmp((char *)&(memberNode->addr.addr), (char *)&(joinaddr->addr), sizeof(memberNode->addr.addr))) {
@@ -167,10 +177,12 @@ int MP1Node::introduceSelfToGroup(Address *joinaddr) {
  *
  * DESCRIPTION: Wind up this node and clean up state
  */
-int MP1Node::finishUpThisNode(){
+template <class Policy>
+int MP1Node<Policy>::finishUpThisNode(){
    /*
     * Your code goes here
     */
+    return SUCCESS;
 }
 
 /**
@@ -179,13 +191,15 @@ int MP1Node::finishUpThisNode(){
  * DESCRIPTION: Executed periodically at each member
  *              Check your messages in queue and perform membership protocol duties
  */
-void MP1Node::nodeLoop() {
+template <class Policy>
+void MP1Node<Policy>::nodeLoop() {
     if (memberNode->bFailed) {
         return;
     }
 
-    // Increase the heartbeat
-    memberNode->heartbeat++;
+    // Increase the heartbeat by the ticks since the last loop
+    memberNode->heartbeat += par->getcurrtime() - lastLoop;
+    lastLoop = par->getcurrtime();
 
     // Check my messages
     checkMessages();
@@ -206,7 +220,8 @@ void MP1Node::nodeLoop() {
  *
  * DESCRIPTION: Check messages in the queue and call the respective message handler
  */
-void MP1Node::checkMessages() {
+template <class Policy>
+void MP1Node<Policy>::checkMessages() {
     void *ptr;
     int size;
 
@@ -216,6 +231,7 @@ void MP1Node::checkMessages() {
         size = memberNode->mp1q.front().size;
         memberNode->mp1q.pop();
         recvCallBack((void *)memberNode, (char *)ptr, size);
+        Queue::release(ptr, size);
     }
     return;
 }
@@ -234,7 +250,8 @@ Address idTOaddr(int id, short port)
  *
  * DESCRIPTION: Message handler for different message types
  */
-bool MP1Node::recvCallBack(void *env, char *data, int size ) {
+template <class Policy>
+bool MP1Node<Policy>::recvCallBack(void *env, char *data, int size ) {
     Member *node = (Member *)env;
 
     if (((MessageHdr *)data)->msgType == JOINREQ)
@@ -250,23 +267,14 @@ bool MP1Node::recvCallBack(void *env, char *data, int size ) {
 
         MemberListEntry newMember(id, port, heartbeat, par->getcurrtime());
         node->memberList.push_back(newMember);
+        armRemoval(newMember);
 
         // Create a log for added node
         log->logNodeAdd(&(node->addr), &(address));
 
         // Create a JOINREP message for new node
-        size_t sizeList = node->memberList.size();
-        size_t msgsize = sizeof(MessageHdr) + sizeof(sizeList) + sizeList * sizeof(MemberListEntry);
-        MessageHdr *msg = (MessageHdr *) malloc(msgsize * sizeof(char));
-
-        msg->msgType = JOINREP;
-        memcpy((char *)(msg+1), &(sizeList), sizeof(sizeList));
-        char *curr = (char *)(msg+1) + sizeof(sizeList);
-        for (auto entry: node->memberList)
-        {
-            memcpy(curr, (char *)&(entry), sizeof(entry));
-            curr = curr + sizeof(entry);
-        }
+        size_t msgsize;
+        MessageHdr *msg = joinRep(&msgsize);
 
         // Send JOINREP to newly added node
         emulNet->ENsend(&(node->addr), &address, (char *)msg, msgsize);
@@ -285,11 +293,12 @@ bool MP1Node::recvCallBack(void *env, char *data, int size ) {
         curr = curr + sizeof(sizeList);
 
         MemberListEntry newEntry;
-        for (int i=0;i<sizeList;++i)
+        for (size_t i=0;i<sizeList;++i)
         {
-            memcpy(&newEntry, curr, sizeof(newEntry));
+            memcpy((void *)&newEntry, curr, sizeof(newEntry));
             curr = curr + sizeof(newEntry);
             node->memberList.push_back(newEntry);
+            armRemoval(newEntry);
 
             Address address = idTOaddr(newEntry.id, newEntry.port);
 
@@ -308,7 +317,7 @@ bool MP1Node::recvCallBack(void *env, char *data, int size ) {
         newEntry.timestamp = par->getcurrtime();
 
         // Check and add nodes which do not exist in your membership list
-        for (int i=0;i<sizeList;++i)
+        for (size_t i=0;i<sizeList;++i)
         {
             memcpy((char *)&newEntry, curr, sizeof(newEntry));
             curr = curr + sizeof(newEntry);
@@ -318,7 +327,8 @@ bool MP1Node::recvCallBack(void *env, char *data, int size ) {
             {
                 if (entry.id == newEntry.id and entry.port == newEntry.port)
                 {
-                    // Update heartbeat of existing nodes
+                    // Update heartbeat of existing nodes; the removal set for the entry is
+                    // now early and is pushed back by removeExpired() when it comes up
                     if (newEntry.heartbeat > entry.heartbeat)
                     {
                         entry = newEntry;
@@ -330,12 +340,14 @@ bool MP1Node::recvCallBack(void *env, char *data, int size ) {
             if (!exists)
             {
                 node->memberList.push_back(newEntry);
+                armRemoval(newEntry);
                 Address address = idTOaddr(newEntry.id, newEntry.port);
 
                 log->logNodeAdd(&(node->addr), &(address));
             }
         }
     }
+    return true;
 }
 
 /**
@@ -345,7 +357,8 @@ bool MP1Node::recvCallBack(void *env, char *data, int size ) {
  *              the nodes
  *              Propagate your membership list
  */
-void MP1Node::nodeLoopOps() {
+template <class Policy>
+void MP1Node<Policy>::nodeLoopOps() {
     // Update your own heartbeat
     for (auto &entry: memberNode->memberList)
     {
@@ -358,18 +371,7 @@ void MP1Node::nodeLoopOps() {
     }
 
     // Delete nodes after TREMOVE time
-    for (auto it=memberNode->memberList.begin();it!=memberNode->memberList.end();)
-    {
-        if (par->getcurrtime() - it->timestamp > TREMOVE)
-        {
-            Address address = idTOaddr(it->id, it->port);
-            log->logNodeRemove(&(memberNode->addr), &address);
-
-            memberNode->memberList.erase(it);
-        }
-        else
-            ++it;
-    }
+    removeExpired();
 
     // Send heartbeat to all nodes in your membership list
     for (auto &target: memberNode->memberList)
@@ -379,7 +381,7 @@ void MP1Node::nodeLoopOps() {
         size_t alive = 0;
         for (auto &entry: memberNode->memberList)
         {
-            if (par->getcurrtime() - entry.timestamp <= TFAIL)
+            if (par->getcurrtime() - entry.timestamp <= policy.tfail)
                 alive++;
         }
 
@@ -392,7 +394,7 @@ void MP1Node::nodeLoopOps() {
         char *curr = (char *)(msg+1) + sizeof(alive);
         for (auto entry: memberNode->memberList)
         {
-            if (par->getcurrtime() - entry.timestamp <= TFAIL)
+            if (par->getcurrtime() - entry.timestamp <= policy.tfail)
             {
                 memcpy(curr, &entry, sizeof(entry));
                 curr = curr + sizeof(entry);
@@ -408,12 +410,131 @@ void MP1Node::nodeLoopOps() {
     return;
 }
 
+/**
+ * FUNCTION NAME: armRemoval
+ *
+ * DESCRIPTION: Set the removal of a member just added to the list, unless it is this node or is
+ * 				listed already with an earlier removal
+ */
+template <class Policy>
+void MP1Node<Policy>::armRemoval(MemberListEntry &entry) {
+    if (idTOaddr(entry.id, entry.port) == memberNode->addr)
+        return;
+
+    long key = TimerWheel::key(entry.id, entry.port);
+    int removeAt = entry.timestamp + policy.tremove + 1;
+    int due = expiry.due(key);
+    if (due < 0 or removeAt < due)
+        expiry.schedule(key, removeAt);
+}
+
+/**
+ * FUNCTION NAME: joinRep
+ *
+ * DESCRIPTION: Build the JOINREP message carrying the membership list, for the caller to free
+ */
+template <class Policy>
+MessageHdr *MP1Node<Policy>::joinRep(size_t *msgsize) {
+    size_t sizeList = memberNode->memberList.size();
+    *msgsize = sizeof(MessageHdr) + sizeof(sizeList) + sizeList * sizeof(MemberListEntry);
+    MessageHdr *msg = (MessageHdr *) malloc(*msgsize * sizeof(char));
+
+    msg->msgType = JOINREP;
+    memcpy((char *)(msg+1), (char *)&(sizeList), sizeof(sizeList));
+    char *curr = (char *)(msg+1) + sizeof(sizeList);
+    for (auto entry: memberNode->memberList)
+    {
+        memcpy(curr, (char *)&(entry), sizeof(entry));
+        curr = curr + sizeof(entry);
+    }
+    return msg;
+}
+
+/**
+ * FUNCTION NAME: removeExpired
+ *
+ * DESCRIPTION: Delete the members not updated for more than TREMOVE, in list order. Only the
+ * 				members whose removal came up are looked at; a tick without any touches no entry.
+ */
+template <class Policy>
+void MP1Node<Policy>::removeExpired() {
+    expiry.expire(par->getcurrtime(), fired);
+    if (fired.empty())
+        return;
+    sort(fired.begin(), fired.end());
+
+    // Earliest removal left among the entries of each fired member, -1 if none is left
+    vector<int> removeAt(fired.size(), -1);
+    MemberList &list = memberNode->memberList;
+    size_t kept = 0;
+    for (size_t i=0;i<list.size();++i)
+    {
+        auto f = lower_bound(fired.begin(), fired.end(), TimerWheel::key(list[i].id, list[i].port));
+        if (f != fired.end() and *f == TimerWheel::key(list[i].id, list[i].port))
+        {
+            if (par->getcurrtime() - list[i].timestamp > policy.tremove)
+            {
+                Address address = idTOaddr(list[i].id, list[i].port);
+                log->logNodeRemove(&(memberNode->addr), &address);
+                continue;
+            }
+            int &at = removeAt[f - fired.begin()];
+            if (at < 0 or list[i].timestamp + policy.tremove + 1 < at)
+                at = list[i].timestamp + policy.tremove + 1;
+        }
+        list[kept++] = list[i];
+    }
+    list.resize(kept);
+
+    for (size_t k=0;k<fired.size();++k)
+    {
+        if (removeAt[k] >= 0)
+            expiry.schedule(fired[k], removeAt[k]);
+    }
+}
+
+/**
+ * FUNCTION NAME: nextWakeup
+ *
+ * DESCRIPTION: Time of the next tick at which nodeLoopOps has work to do, or -1 if the node only
+ * 				needs to run when a message arrives. Heartbeats are gossiped every tick once in the group.
+ */
+template <class Policy>
+int MP1Node<Policy>::nextWakeup() {
+	if (memberNode->bFailed || !memberNode->inGroup) {
+		return -1;
+	}
+	return par->getcurrtime() + 1;
+}
+
+/**
+ * FUNCTION NAME: quiescent
+ *
+ * DESCRIPTION: Always true: the node sends its whole list out every tick whether or not it changed, so
+ * 				there is no news it still has to spread once the lists agree
+ */
+template <class Policy>
+bool MP1Node<Policy>::quiescent() {
+	return true;
+}
+
+/**
+ * FUNCTION NAME: bytesUsed
+ *
+ * DESCRIPTION: Bytes held by this node's membership list, queue and removal timers
+ */
+template <class Policy>
+long MP1Node<Policy>::bytesUsed() {
+	return memberNode->bytesUsed() + expiry.bytesUsed();
+}
+
 /**
  * FUNCTION NAME: isNullAddress
  *
  * DESCRIPTION: Function checks if the address is NULL
  */
-int MP1Node::isNullAddress(Address *addr) {
+template <class Policy>
+int MP1Node<Policy>::isNullAddress(Address *addr) {
 	return (memcmp(addr->addr, NULLADDR, 6) == 0 ? 1 : 0);
 }
 
@@ -422,10 +543,11 @@ int MP1Node::isNullAddress(Address *addr) {
  *
  * DESCRIPTION: Returns the Address of the coordinator
  */
-Address MP1Node::getJoinAddress() {
+template <class Policy>
+Address MP1Node<Policy>::getJoinAddress() {
     Address joinaddr;
 
-    memset(&joinaddr, 0, sizeof(Address));
+    memset(joinaddr.addr, 0, sizeof(joinaddr.addr));
     *(int *)(&joinaddr.addr) = 1;
     *(short *)(&joinaddr.addr[4]) = 0;
 
@@ -437,7 +559,8 @@ Address MP1Node::getJoinAddress() {
  *
  * DESCRIPTION: Initialize the membership list
  */
-void MP1Node::initMemberListTable(Member *memberNode) {
+template <class Policy>
+void MP1Node<Policy>::initMemberListTable(Member *memberNode) {
 	memberNode->memberList.clear();
 }
 
@@ -446,8 +569,23 @@ void MP1Node::initMemberListTable(Member *memberNode) {
  *
  * DESCRIPTION: Print the Address
  */
-void MP1Node::printAddress(Address *addr)
+template <class Policy>
+void MP1Node<Policy>::printAddress(Address *addr)
 {
     printf("%d.%d.%d.%d:%d \n",  addr->addr[0],addr->addr[1],addr->addr[2],
                                                        addr->addr[3], *(short*)&addr->addr[4]) ;    
 }
+
+/*
+ * Selected by PROTOCOL: AllToAll. The first whose policy takes the run's constants is made: the
+ * build's, then common settings of them, then the RuntimePolicy for any other.
+ */
+static ProtocolRegistrar<MP1Node<BuiltPolicy> > built("AllToAll");
+// Failures removed in half the time
+static ProtocolRegistrar<MP1Node<FixedPolicy<10, 3> > > quickRemoval("AllToAll");
+static ProtocolRegistrar<MP1Node<RuntimePolicy> > anyConstants("AllToAll");
+
+template class MP1Node<BuiltPolicy>;
+template class MP1Node<RuntimePolicy>;
+
+} /* namespace alltoall */
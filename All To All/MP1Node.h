@@ -12,19 +12,28 @@
 #include "Log.h"
 #include "Params.h"
 #include "Member.h"
+#include "Protocol.h"
 #include "EmulNet.h"
 #include "Queue.h"
+#include "TimerWheel.h"
 
 /**
  * Macros
+ * Protocol constants, can be overridden at build time with make DEFINES="-D<NAME>=<value>"
  */
+#ifndef TREMOVE
 #define TREMOVE 20
+#endif
+#ifndef TFAIL
 #define TFAIL 5
+#endif
 
 /*
  * Note: You can change/add any functions in MP1Node.{h,cpp}
  */
 
+namespace alltoall {
+
 /**
  * Message Types
  */
@@ -43,21 +52,73 @@ typedef struct MessageHdr {
 	enum MsgTypes msgType;
 }MessageHdr;
 
+/**
+ * CLASS NAME: FixedPolicy
+ *
+ * DESCRIPTION: Protocol constants fixed at compile time. MP1Node reads its constants from its
+ * 				policy, so a node of a FixedPolicy has them folded into its loops. It takes the runs
+ * 				whose constants, as set by the test case or else by the build, are exactly its own.
+ */
+template <int Tremove, int Tfail>
+class FixedPolicy {
+public:
+	static constexpr int tremove = Tremove;
+	static constexpr int tfail = Tfail;
+	FixedPolicy(Params *) {}
+	static bool accepts(Params *par) {
+		return par->constant("TREMOVE", TREMOVE) == tremove && par->constant("TFAIL", TFAIL) == tfail;
+	}
+};
+
+/**
+ * CLASS NAME: RuntimePolicy
+ *
+ * DESCRIPTION: Protocol constants read from the test case when the node is made, for the runs no
+ * 				FixedPolicy takes
+ */
+class RuntimePolicy {
+public:
+	int tremove;
+	int tfail;
+	RuntimePolicy(Params *par):
+			tremove(par->constant("TREMOVE", TREMOVE)),
+			tfail(par->constant("TFAIL", TFAIL)) {}
+	static bool accepts(Params *) {
+		return true;
+	}
+};
+
+// The constants of the build (TREMOVE, TFAIL above)
+typedef FixedPolicy<TREMOVE, TFAIL> BuiltPolicy;
+
 /**
  * CLASS NAME: MP1Node
  *
- * DESCRIPTION: Class implementing Membership protocol functionalities for failure detection
+ * DESCRIPTION: Class implementing Membership protocol functionalities for failure detection.
+ * 				Its constants come from the Policy, a FixedPolicy or the RuntimePolicy.
  */
-class MP1Node {
+template <class Policy>
+class MP1Node : public Protocol {
 private:
 	EmulNet *emulNet;
 	Log *log;
 	Params *par;
 	Member *memberNode;
+	// Protocol constants
+	Policy policy;
+	// time of the last nodeLoop, heartbeats advance by the ticks elapsed since
+	int lastLoop;
+	// When each member other than this node is due to be removed, TREMOVE after its last update
+	TimerWheel expiry;
+	// Members whose removal came up at the current tick
+	vector<long> fired;
 	char NULLADDR[6];
 
 public:
 	MP1Node(Member *, Params *, EmulNet *, Log *, Address *);
+	static bool accepts(Params *par) {
+		return Policy::accepts(par);
+	}
 	Member * getMemberNode() {
 		return memberNode;
 	}
@@ -71,6 +132,12 @@ public:
 	void checkMessages();
 	bool recvCallBack(void *env, char *data, int size);
 	void nodeLoopOps();
+	void armRemoval(MemberListEntry &entry);
+	void removeExpired();
+	MessageHdr *joinRep(size_t *msgsize);
+	int nextWakeup();
+	bool quiescent();
+	long bytesUsed();
 	int isNullAddress(Address *addr);
 	Address getJoinAddress();
 	void initMemberListTable(Member *memberNode);
@@ -78,4 +145,10 @@ public:
 	virtual ~MP1Node();
 };
 
+// Made outside MP1Node.cpp by the microbenchmarks
+extern template class MP1Node<BuiltPolicy>;
+extern template class MP1Node<RuntimePolicy>;
+
+} /* namespace alltoall */
+
 #endif /* _MP1NODE_H_ */
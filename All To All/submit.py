@@ -37,7 +37,7 @@ print('submission scripts assume that you have Python installed as well.)\n')
 
 # Python2/3 compatibility hacks: ----------------------------
 
-anchoring_file = 'Application.cpp'
+anchoring_file = 'MP1Node.cpp'
 
 # Message displayed if compatibility hacks fail
 compat_fail_msg = '\n\nERROR: Python 3 compatibility fix failed.\nPlease try running the script with the "python2" command instead of "python" or "python3".\n\n'
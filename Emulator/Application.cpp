@@ -0,0 +1,1123 @@
+/**********************************
+ * FILE NAME: Application.cpp
+ *
+ * DESCRIPTION: Application layer class function definitions
+ **********************************/
+
+#include "Application.h"
+#include "MonteCarlo.h"
+
+void handler(int sig) {
+	void *array[10];
+	size_t size;
+
+	// get void*'s for all entries on the stack
+	size = backtrace(array, 10);
+
+	// print out all the frames to stderr
+	fprintf(stderr, "Error: signal %d:\n", sig);
+	backtrace_symbols_fd(array, size, STDERR_FILENO);
+	exit(1);
+}
+
+/**
+ * FUNCTION NAME: loadParams
+ *
+ * DESCRIPTION: Read a test case, NULL if it names a protocol that is not linked in
+ */
+Params *loadParams(const char *conf) {
+	Params *par = new Params();
+	par->setparams((char *)conf);
+	if ( !ProtocolRegistry::find(par) ) {
+		fprintf(stderr, "%s: %s names none of the protocols built in (%s)\n", conf,
+				par->PROTOCOL.empty() ? "PROTOCOL" : par->PROTOCOL.c_str(), ProtocolRegistry::names().c_str());
+		delete par;
+		return NULL;
+	}
+	return par;
+}
+
+/**********************************
+ * FUNCTION NAME: main
+ *
+ * DESCRIPTION: main function. Start from here
+ **********************************/
+int main(int argc, char *argv[]) {
+	//signal(SIGSEGV, handler);
+	if ( argc < ARGS_COUNT ) {
+		cout<<"Configuration (i.e., *.conf) file File Required"<<endl;
+		return FAILURE;
+	}
+
+	if ( argc == ARGS_COUNT ) {
+		Params *par = loadParams(argv[1]);
+		if ( !par ) {
+			return FAILURE;
+		}
+		if ( par->TRIALS > 0 ) {
+			// Estimate the error rates over many seeded trials instead of running once
+			MonteCarlo *estimate = new MonteCarlo(par, stdout);
+			int status = estimate->run();
+			delete estimate;
+			delete par;
+			return status;
+		}
+		// Create a new application object
+		Application *app = new Application(par);
+		// Call the run function
+		app->run();
+		// When done delete the application object
+		delete(app);
+
+		return SUCCESS;
+	}
+
+	// Several test cases: each one runs on its own thread and writes to its own directory run-<k>
+	vector<Application *> apps;
+	vector<thread> threads;
+	char dir[32];
+	int k;
+
+	for ( k = 1; k < argc; k++ ) {
+		Params *par = loadParams(argv[k]);
+		if ( par ) {
+			sprintf(dir, "run-%d", k - 1);
+			apps.push_back(new Application(par, dir));
+		}
+		if ( !par || par->TRIALS > 0 || apps.back()->forks() ) {
+			if ( par ) {
+				fprintf(stderr, "%s: estimates, sharded runs and scenario branches can only run alone\n", argv[k]);
+			}
+			for ( unsigned int j = 0; j < apps.size(); j++ ) {
+				delete apps[j];
+			}
+			return FAILURE;
+		}
+	}
+	for ( k = 0; k < (int)apps.size(); k++ ) {
+		threads.push_back(thread(&Application::run, apps[k]));
+	}
+	for ( k = 0; k < (int)apps.size(); k++ ) {
+		threads[k].join();
+		delete apps[k];
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Constructor of the Application class, for the test case par, which it takes over
+ * With outdir the run writes its logs and what it prints (REPORT_FILE) to that directory, unless
+ * the test case names its own OUTPUT_DIR. A quiet run prints nothing.
+ */
+Application::Application(Params *par, const char *outdir) {
+	Memory::bind(&memory);
+	this->par = par;
+	out = par->quiet ? NULL : stdout;
+	if ( outdir && par->OUTPUT_DIR.empty() ) {
+		par->OUTPUT_DIR = outdir;
+	}
+	if ( !par->OUTPUT_DIR.empty() ) {
+		mkdir(par->OUTPUT_DIR.c_str(), 0755);
+	}
+	if ( outdir ) {
+		out = fopen(par->path(REPORT_FILE).c_str(), "w");
+		if ( out == NULL ) {
+			perror(par->path(REPORT_FILE).c_str());
+			out = stdout;
+		}
+	}
+	nodeCount = 0;
+	oracle = new Oracle(par);
+	log = new Log(par);
+	log->setOracle(oracle);
+	en = new EmulNet(par);
+	nodesFrom = 0;
+	nodesTo = par->EN_GPSZ;
+	link = NULL;
+	nodePeak = 0;
+	quiescentAt = -1;
+	sentFrom = -1;
+	memoryLog = NULL;
+
+	protocol = ProtocolRegistry::find(par);
+
+	/*
+	 * Init all nodes; the shards of a sharded run each create their own once forked
+	 */
+	if ( par->SHARDS <= 1 ) {
+		makeNodes(0, par->EN_GPSZ);
+	}
+
+	scenario = new Scenario(par);
+	joinedAt.assign(par->EN_GPSZ, -1);
+	down.assign(par->EN_GPSZ, false);
+	nextPartition = 1;
+	partitioned = false;
+
+	wakeAt.assign(par->EN_GPSZ, -1);
+	steppedAt.assign(par->EN_GPSZ, -1);
+
+	pool = NULL;
+	if ( par->THREADS > 1 ) {
+		pool = new WorkPool(par->THREADS, [this]() { Memory::bind(&memory); });
+	}
+
+	nodeLocks = NULL;
+	if ( par->REALTIME ) {
+		nodeLocks = new mutex[par->EN_GPSZ];
+		lateness.resize(par->EN_GPSZ);
+	}
+}
+
+/**
+ * Destructor
+ */
+Application::~Application() {
+	Memory::bind(&memory);
+	delete pool;
+	delete[] nodeLocks;
+	delete link;
+	if ( memoryLog ) {
+		fclose(memoryLog);
+	}
+	delete scenario;
+	delete log;
+	delete oracle;
+	delete en;
+	mp1.clear();
+	delete par;
+	if ( out && out != stdout ) {
+		fclose(out);
+	}
+	Memory::bind(NULL);
+}
+
+/**
+ * FUNCTION NAME: getOracle
+ *
+ * DESCRIPTION: The oracle that followed the run
+ */
+Oracle *Application::getOracle() {
+	return oracle;
+}
+
+/**
+ * FUNCTION NAME: forks
+ *
+ * DESCRIPTION: True if the run forks processes, which it can only do when it is alone in this one
+ */
+bool Application::forks() {
+	return par->SHARDS > 1 || scenario->branches() > 0;
+}
+
+/**
+ * FUNCTION NAME: run
+ *
+ * DESCRIPTION: Main driver function of the Application layer
+ */
+int Application::run()
+{
+	int i;
+	// The run may be on another thread than the one it was made on
+	Memory::bind(&memory);
+
+	struct timeval start, end;
+	struct rusage usage;
+
+	gettimeofday(&start, NULL);
+	double cpuStart = cpuSeconds();
+
+	// Without an explicit checkpoint the branches share everything up to their first event
+	int checkpoint = par->CHECKPOINT >= 0 ? par->CHECKPOINT : scenario->firstBranchTime();
+
+	if ( par->REALTIME ) {
+		// Every node runs on its own thread against the wall clock
+		runRealtime();
+	}
+	else if ( par->SHARDS > 1 ) {
+		// The nodes are stepped by forked shard processes, this one keeps the scenario and the oracle
+		runSharded();
+	}
+	else {
+		// As time runs along
+		for( par->globaltime = 0; par->globaltime < par->TOTAL_TIME; ++par->globaltime ) {
+			// Fork the what-if branches off the run so far; this process only waits for them
+			if ( par->globaltime == checkpoint && !forkBranches() ) {
+				break;
+			}
+			if ( par->globaltime == par->MEASURE_FROM ) {
+				sentFrom = en->ENsentTotal();
+			}
+			// Join, fail and partition nodes as the scenario says
+			runScenario();
+			// Run the membership protocol
+			if ( par->EVENT_DRIVEN ) {
+				mp1RunEvents();
+			}
+			else if ( pool ) {
+				mp1RunParallel();
+			}
+			else {
+				mp1Run();
+			}
+			oracle->endTick();
+			sampleMemory();
+			// Deliver this tick's messages
+			en->ENtick();
+			// Nothing that is left of the run can change a view
+			if ( par->QUIESCENCE && quiescent(checkpoint) ) {
+				quiescentAt = par->globaltime++;
+				break;
+			}
+		}
+	}
+
+	// The messages of a sharded run were sent by its shards
+	unsigned long sent = link ? link->sentTotal() : en->ENsentTotal();
+	// Grade the run, unless it only led up to a checkpoint or is quiet
+	if ( (par->globaltime == par->TOTAL_TIME || quiescentAt >= 0) && out ) {
+		if ( quiescentAt >= 0 ) {
+			fprintf(out, "Quiescent at time=%d of %d\n", quiescentAt, par->TOTAL_TIME);
+		}
+		oracle->grade(out);
+		oracle->report(out);
+		if ( sentFrom >= 0 ) {
+			fprintf(out, "Messages from time=%d: %.3f per live node per tick\n", par->MEASURE_FROM,
+					(double)(sent - sentFrom) / max(oracle->measuredNodeTicks(), 1L));
+		}
+		reportMemory(out);
+	}
+
+	gettimeofday(&end, NULL);
+	getrusage(RUSAGE_SELF, &usage);
+	double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+	// A forked branch only counts what it used itself
+	double cpu = max(cpuSeconds() - cpuStart, 0.0);
+	// ru_maxrss is in kilobytes
+	if ( out ) {
+		fprintf(out, "Ran %d nodes for %d ticks in %.3f s (%.1f ticks/s), %lu messages (%lu bytes), peak RSS %ld KB (%.2f KB per node), cpu %.3f s\n",
+				par->EN_GPSZ, par->globaltime, elapsed, par->globaltime / max(elapsed, 1e-9),
+				sent, link ? link->sentBytes() : en->ENsentBytes(),
+				usage.ru_maxrss, (double)usage.ru_maxrss / par->EN_GPSZ, cpu);
+	}
+	if ( link ) {
+		getrusage(RUSAGE_CHILDREN, &usage);
+		fprintf(out, "Largest of %d shards: peak RSS %ld KB\n", par->SHARDS, usage.ru_maxrss);
+	}
+
+	// Clean up; the shards wrote msgcount.log themselves
+	if ( !link ) {
+		en->ENcleanup();
+	}
+
+	for(i=0;i<=par->EN_GPSZ-1;i++) {
+		if ( mp1[i] ) {
+			mp1[i]->finishUpThisNode();
+		}
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * FUNCTION NAME: cpuSeconds
+ *
+ * DESCRIPTION: User and system time used so far by this process and the shards and branches it
+ * 				waited for
+ */
+double Application::cpuSeconds() {
+	struct rusage self, children;
+
+	getrusage(RUSAGE_SELF, &self);
+	getrusage(RUSAGE_CHILDREN, &children);
+	return self.ru_utime.tv_sec + self.ru_utime.tv_usec / 1e6 + self.ru_stime.tv_sec + self.ru_stime.tv_usec / 1e6
+			+ children.ru_utime.tv_sec + children.ru_utime.tv_usec / 1e6 + children.ru_stime.tv_sec + children.ru_stime.tv_usec / 1e6;
+}
+
+/**
+ * FUNCTION NAME: mp1Run
+ *
+ * DESCRIPTION:	This function performs all the membership protocol functionalities
+ */
+void Application::mp1Run() {
+	int i;
+
+	// For all the nodes in the system
+	for( i = nodesFrom; i <= nodesTo-1; i++) {
+
+		/*
+		 * Receive messages from the network and queue them in the membership protocol queue
+		 */
+		if( isRunning(i) ) {
+			// Receive messages from the network and queue them
+			mp1[i]->recvLoop();
+		}
+
+	}
+
+	// For all the nodes in the system
+	for( i = nodesTo - 1; i >= nodesFrom; i-- ) {
+
+		/*
+		 * Introduce nodes into the distributed system
+		 */
+		if( par->getcurrtime() == joinedAt[i] ) {
+			// introduce the ith node into the system at the time the scenario says
+			startNode(i);
+		}
+
+		/*
+		 * Handle all the messages in your queue and send heartbeats
+		 */
+		else if( isRunning(i) ) {
+			// handle messages and send heartbeats
+			mp1[i]->nodeLoop();
+			#ifdef DEBUGLOG
+			if( (i == 0) && (par->globaltime % 500 == 0) ) {
+				log->LOG(&mp1[i]->getMemberNode()->addr, "@@time=%d", par->getcurrtime());
+			}
+			#endif
+		}
+
+	}
+}
+
+/**
+ * FUNCTION NAME: mp1RunParallel
+ *
+ * DESCRIPTION:	Same tick as mp1Run, with the receive phase and the nodeLoop phase spread over
+ * 				the work pool. Each run over the pool ends in a barrier. The network is double
+ * 				buffered and log lines are staged per node and flushed in the serial order,
+ * 				so the outcome for a given seed does not depend on the number of threads.
+ */
+void Application::mp1RunParallel() {
+	int i;
+
+	log->stage(true);
+
+	pool->run(par->EN_GPSZ, [this](int i) {
+		if( isRunning(i) ) {
+			mp1[i]->recvLoop();
+		}
+	});
+
+	/*
+	 * Introduce nodes into the distributed system
+	 */
+	sort(starting.begin(), starting.end(), greater<int>());
+	for( i = 0; i < (int)starting.size(); i++ ) {
+		startNode(starting[i]);
+	}
+
+	pool->run(par->EN_GPSZ, [this](int i) {
+		if( isRunning(i) ) {
+			mp1[i]->nodeLoop();
+			#ifdef DEBUGLOG
+			if( (i == 0) && (par->globaltime % 500 == 0) ) {
+				log->LOG(&mp1[i]->getMemberNode()->addr, "@@time=%d", par->getcurrtime());
+			}
+			#endif
+		}
+	});
+
+	log->stage(false);
+	log->flush();
+}
+
+/**
+ * FUNCTION NAME: mp1RunEvents
+ *
+ * DESCRIPTION:	Event driven tick. Only nodes that are introduced now, that got messages at the
+ * 				last tick boundary or whose own wakeup (MP1Node::nextWakeup) is due are stepped,
+ * 				so idle nodes cost nothing. Due nodes are stepped in the same order as mp1Run.
+ */
+void Application::mp1RunEvents() {
+	int i, next;
+	unsigned int k;
+	int time = par->getcurrtime();
+	vector<int> due;
+
+	// Nodes whose timer fired; entries superseded by a later nextWakeup are stale
+	while ( !timers.empty() && timers.top().first <= time ) {
+		i = timers.top().second;
+		if ( wakeAt[i] == timers.top().first && steppedAt[i] != time ) {
+			steppedAt[i] = time;
+			due.push_back(i);
+		}
+		timers.pop();
+	}
+
+	// Nodes with new messages
+	vector<int> &delivered = en->ENdelivered();
+	for ( k = 0; k < delivered.size(); k++ ) {
+		i = delivered[k] - 1;
+		if ( i >= 0 && i < par->EN_GPSZ && steppedAt[i] != time ) {
+			steppedAt[i] = time;
+			due.push_back(i);
+		}
+	}
+
+	// Drop the nodes that are not running
+	for ( k = 0; k < due.size(); ) {
+		i = due[k];
+		if ( !isRunning(i) ) {
+			due[k] = due.back();
+			due.pop_back();
+		}
+		else {
+			k++;
+		}
+	}
+
+	if ( pool ) {
+		log->stage(true);
+		pool->run(due.size(), [this, &due](int k) { mp1[due[k]]->recvLoop(); });
+	}
+	else {
+		for ( k = 0; k < due.size(); k++ ) {
+			mp1[due[k]]->recvLoop();
+		}
+	}
+
+	// Nodes introduced at this time
+	unsigned int running = due.size();
+	due.insert(due.end(), starting.begin(), starting.end());
+
+	if ( pool ) {
+		sort(due.begin() + running, due.end(), greater<int>());
+		for ( k = running; k < due.size(); k++ ) {
+			startNode(due[k]);
+		}
+		pool->run(running, [this, &due](int k) { mp1[due[k]]->nodeLoop(); });
+		log->stage(false);
+		log->flush();
+	}
+	else {
+		// Same order as mp1Run
+		sort(due.begin(), due.end(), greater<int>());
+		for ( k = 0; k < due.size(); k++ ) {
+			i = due[k];
+			if ( time == joinedAt[i] ) {
+				startNode(i);
+			}
+			else {
+				mp1[i]->nodeLoop();
+			}
+		}
+	}
+	#ifdef DEBUGLOG
+	// Node 0 steps last in mp1Run, where the marker follows its nodeLoop; here it may not be due
+	if( isRunning(0) && (time % 500 == 0) ) {
+		log->LOG(&mp1[0]->getMemberNode()->addr, "@@time=%d", time);
+	}
+	#endif
+
+	// Ask every stepped node when it next needs to run
+	for ( k = 0; k < due.size(); k++ ) {
+		i = due[k];
+		next = mp1[i]->nextWakeup();
+		wakeAt[i] = next;
+		if ( next > time ) {
+			timers.push(make_pair(next, i));
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: runRealtime
+ *
+ * DESCRIPTION: Real time run. Every node steps on its own thread once per TICK_MS of the monotonic
+ * 				clock, delivering through the locked shared network buffer as it goes, so the
+ * 				protocol sees real scheduling jitter. This thread is the driver: at every tick
+ * 				boundary it takes all node locks, applies the scenario, introduces nodes and lets
+ * 				the oracle catch up. Scenario branches are not forked in this mode.
+ */
+void Application::runRealtime() {
+	int i, tick;
+	unsigned int k;
+	vector<thread> threads;
+	Histogram late;
+
+	par->startClock();
+	for ( i = 0; i < par->EN_GPSZ; i++ ) {
+		threads.push_back(thread(&Application::nodeThread, this, i));
+	}
+
+	for ( tick = 0; tick < par->TOTAL_TIME; tick++ ) {
+		waitUntil(tick * par->TICK_MS * 1000L);
+		// Node locks are only ever taken one at a time by the node threads, so no deadlock
+		for ( i = 0; i < par->EN_GPSZ; i++ ) {
+			nodeLocks[i].lock();
+		}
+		par->globaltime = tick;
+		if ( tick == par->MEASURE_FROM ) {
+			sentFrom = en->ENsentTotal();
+		}
+		runScenario();
+		sort(starting.begin(), starting.end(), greater<int>());
+		for ( k = 0; k < starting.size(); k++ ) {
+			startNode(starting[k]);
+		}
+		oracle->endTick();
+		sampleMemory();
+		for ( i = par->EN_GPSZ - 1; i >= 0; i-- ) {
+			nodeLocks[i].unlock();
+		}
+	}
+
+	for ( k = 0; k < threads.size(); k++ ) {
+		threads[k].join();
+	}
+	par->stopClock();
+	par->globaltime = par->TOTAL_TIME;
+
+	for ( i = 0; i < par->EN_GPSZ; i++ ) {
+		for ( k = 0; k < lateness[i].size(); k++ ) {
+			late.add(lateness[i][k]);
+		}
+	}
+	late.summary(out, "Step lateness (us)");
+}
+
+/**
+ * FUNCTION NAME: nodeThread
+ *
+ * DESCRIPTION: Real time mode: step the ith node once per tick until the run is over. Each node
+ * 				has its own phase within the tick, so the nodes do not all wake up together.
+ */
+void Application::nodeThread(int i) {
+	unsigned int seed = par->SEED + 104729 * (i + 1);
+	long period = par->TICK_MS * 1000L;
+	long phase = rand_r(&seed) % period;
+	long due;
+
+	Memory::bind(&memory);
+
+	for ( int tick = 1; tick < par->TOTAL_TIME; tick++ ) {
+		due = tick * period + phase;
+		waitUntil(due);
+		lock_guard<mutex> guard(nodeLocks[i]);
+		if ( isRunning(i) ) {
+			lateness[i].push_back((int)(par->clockMicros() - due));
+			mp1[i]->recvLoop();
+			mp1[i]->nodeLoop();
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: waitUntil
+ *
+ * DESCRIPTION: Real time mode: sleep until the clock reads the given number of microseconds
+ */
+void Application::waitUntil(long micros) {
+	struct timespec at = par->clockStart;
+	at.tv_sec += micros / 1000000;
+	at.tv_nsec += (micros % 1000000) * 1000;
+	if ( at.tv_nsec >= 1000000000L ) {
+		at.tv_sec++;
+		at.tv_nsec -= 1000000000L;
+	}
+	while ( clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &at, NULL) == EINTR );
+}
+
+// Shard processes of a sharded run, for shardDied
+static vector<pid_t> shards;
+
+/**
+ * FUNCTION NAME: shardDied
+ *
+ * DESCRIPTION: SIGCHLD handler of a sharded run. A shard only exits with SUCCESS after the last
+ * 				barrier; one that exits otherwise would leave the rest waiting at the barrier
+ * 				forever, so they are killed and the run fails.
+ */
+void shardDied(int sig) {
+	int status;
+	pid_t pid;
+
+	while ( (pid = waitpid(-1, &status, WNOHANG)) > 0 ) {
+		if ( WIFEXITED(status) && WEXITSTATUS(status) == SUCCESS ) {
+			continue;
+		}
+		const char *msg = "A shard died, the sharded run is stopped\n";
+		write(STDERR_FILENO, msg, strlen(msg));
+		for ( pid_t shard: shards ) {
+			kill(shard, SIGKILL);
+		}
+		_exit(FAILURE);
+	}
+}
+
+/**
+ * FUNCTION NAME: runSharded
+ *
+ * DESCRIPTION: Sharded run. SHARDS worker processes are forked, each stepping a contiguous range
+ * 				of the nodes in lock step with this process, which keeps the scenario and the
+ * 				oracle: it hands out the events of every tick and collects the view changes the
+ * 				shards report (see ShardLink). Messages cross between shards at the tick boundary,
+ * 				like in the double-buffered network, so the run takes the course of a DOUBLE_BUFFER
+ * 				run with the same seed; only the order of the lines of dbg.log differs. Scenario branches are not forked in this mode. If a shard dies,
+ * 				or this process does, the others are killed and the run fails.
+ */
+void Application::runSharded() {
+	int k, j, status;
+	unsigned int e;
+	ScenarioEvent ev;
+	vector<ScenarioEvent> events;
+	sigset_t childSignal, mask;
+	pid_t controller = getpid();
+
+	if ( scenario->branches() > 0 ) {
+		fprintf(stderr, "Scenario branches are not forked in a sharded run\n");
+	}
+
+	// Everything the shards share has to exist before they are forked
+	link = new ShardLink(par, par->SHARDS);
+	log->share();
+	// The shards append their nodes to it in turn
+	fclose(fopen(par->path(MSGCOUNT_LOG_FILE).c_str(), "w"));
+	fflush(out);
+
+	// Shards that die while they are forked are seen once shardDied is in place
+	sigemptyset(&childSignal);
+	sigaddset(&childSignal, SIGCHLD);
+	sigprocmask(SIG_BLOCK, &childSignal, &mask);
+	shards.clear();
+	for ( k = 0; k < par->SHARDS; k++ ) {
+		pid_t pid = fork();
+		if ( pid < 0 ) {
+			// The others would wait at the barrier forever
+			perror("fork");
+			for ( j = 0; j < (int)shards.size(); j++ ) {
+				kill(shards[j], SIGKILL);
+			}
+			exit(FAILURE);
+		}
+		if ( pid == 0 ) {
+			sigprocmask(SIG_SETMASK, &mask, NULL);
+			// Nor would the shards get past it without this process
+			prctl(PR_SET_PDEATHSIG, SIGKILL);
+			if ( getppid() != controller ) {
+				_exit(FAILURE);
+			}
+			runShard(k);
+		}
+		shards.push_back(pid);
+	}
+	signal(SIGCHLD, shardDied);
+	sigprocmask(SIG_SETMASK, &mask, NULL);
+
+	for( par->globaltime = 0; par->globaltime < par->TOTAL_TIME; ++par->globaltime ) {
+		if ( par->globaltime == par->MEASURE_FROM ) {
+			sentFrom = link->sentTotal();
+		}
+		events.clear();
+		while ( scenario->nextDue(par->getcurrtime(), ev) ) {
+			events.push_back(ev);
+		}
+		link->publish(events);
+		link->wait();
+
+		// Same bookkeeping as the shards, for the oracle
+		starting.clear();
+		for ( e = 0; e < events.size(); e++ ) {
+			applyEvent(events[e]);
+		}
+		sort(starting.begin(), starting.end(), greater<int>());
+		for ( e = 0; e < starting.size(); e++ ) {
+			startNode(starting[e]);
+		}
+
+		link->wait();
+		for ( k = 0; k < link->shards(); k++ ) {
+			for ( j = 0; j < link->views(k); j++ ) {
+				ShardView &v = link->view(k, j);
+				oracle->addChange(v.observer, ViewChange(v.subject, v.time, v.added));
+			}
+		}
+		oracle->endTick();
+	}
+
+	// One round per shard writing its part of msgcount.log
+	for ( k = 0; k < link->shards(); k++ ) {
+		link->wait();
+	}
+	// shardDied may have reaped some of them already
+	for ( k = 0; k < (int)shards.size(); k++ ) {
+		waitpid(shards[k], &status, 0);
+	}
+	signal(SIGCHLD, SIG_DFL);
+}
+
+/**
+ * FUNCTION NAME: runShard
+ *
+ * DESCRIPTION: Body of a forked shard: create its nodes, step them every tick and pass their
+ * 				messages and view changes on. Does not return.
+ */
+void Application::runShard(int shard) {
+	int i, k;
+	unsigned int e;
+	vector<ScenarioEvent> events;
+	vector<ViewChange> changes;
+
+	link->attach(shard);
+	nodesFrom = link->first(shard);
+	nodesTo = link->last(shard);
+	en->ENfirstId(nodesFrom + 1);
+	makeNodes(nodesFrom, nodesTo);
+	en->ENsetShard(link);
+
+	for( par->globaltime = 0; par->globaltime < par->TOTAL_TIME; ++par->globaltime ) {
+		link->wait();
+		link->receive(events);
+		link->clearQueues();
+
+		starting.clear();
+		for ( e = 0; e < events.size(); e++ ) {
+			applyEvent(events[e]);
+		}
+		mp1Run();
+
+		for ( i = nodesFrom + 1; i <= nodesTo; i++ ) {
+			oracle->takeChanges(i, changes);
+			for ( e = 0; e < changes.size(); e++ ) {
+				link->report(i, changes[e].subject, changes[e].time, changes[e].added);
+			}
+		}
+		sampleMemory();
+		en->ENexport();
+		// Every tick, for the controller's message rate from MEASURE_FROM on
+		link->setTotals(en->ENsentTotal(), en->ENsentBytes());
+		link->wait();
+		// Deliver this tick's messages, the other shards' queues included
+		en->ENtick();
+	}
+
+	for ( k = 0; k < MEM_TAGS; k++ ) {
+		link->setMemory(k, memory.peakBytes(k));
+	}
+	link->setMemory(MEM_TAGS, memory.totalPeakBytes());
+	link->setMemory(MEM_TAGS + 1, nodePeak);
+	for ( k = 0; k < link->shards(); k++ ) {
+		if ( k == shard ) {
+			en->ENcleanup();
+		}
+		link->wait();
+	}
+	fflush(out);
+	exit(SUCCESS);
+}
+
+/**
+ * FUNCTION NAME: sampleMemory
+ *
+ * DESCRIPTION: Called at the end of every tick: raise the peaks of the subsystems, keep track of
+ * 				the largest node and, every MEMORY_LOG ticks, append the bytes held per subsystem
+ * 				and per node to memory.log.
+ * 				A shard only looks at its own nodes and does not write memory.log.
+ */
+void Application::sampleMemory() {
+	int i, k, held = 0;
+	long bytes, sum = 0, most = 0;
+
+	memory.sample();
+	for ( i = nodesFrom; i < nodesTo; i++ ) {
+		if ( mp1[i] ) {
+			bytes = mp1[i]->bytesUsed();
+			sum += bytes;
+			most = max(most, bytes);
+			held++;
+		}
+	}
+	nodePeak = max(nodePeak, most);
+
+	if ( par->MEMORY_LOG <= 0 || link || par->getcurrtime() % par->MEMORY_LOG != 0 ) {
+		return;
+	}
+	if ( memoryLog == NULL ) {
+		memoryLog = fopen(par->path(MEMORY_LOG_FILE).c_str(), "w");
+		fprintf(memoryLog, "# time");
+		for ( k = 0; k < MEM_TAGS; k++ ) {
+			fprintf(memoryLog, " %s", Memory::name(k));
+		}
+		fprintf(memoryLog, " total node_mean node_max\n");
+	}
+	fprintf(memoryLog, "%d", par->getcurrtime());
+	for ( k = 0; k < MEM_TAGS; k++ ) {
+		fprintf(memoryLog, " %ld", memory.bytes(k));
+	}
+	fprintf(memoryLog, " %ld %ld %ld\n", memory.totalBytes(), held ? sum / held : 0, most);
+}
+
+/**
+ * FUNCTION NAME: reportMemory
+ *
+ * DESCRIPTION: Print the peak bytes of every subsystem, of all of them together, per node and of
+ * 				the largest node on one line. A sharded run adds up the peaks of the shards.
+ */
+void Application::reportMemory(FILE *fp) {
+	long peaks[MEM_TAGS + 2];
+	int k, j;
+
+	for ( k = 0; k < MEM_TAGS; k++ ) {
+		peaks[k] = memory.peakBytes(k);
+	}
+	peaks[MEM_TAGS] = memory.totalPeakBytes();
+	peaks[MEM_TAGS + 1] = nodePeak;
+	if ( link ) {
+		for ( k = 0; k < MEM_TAGS + 2; k++ ) {
+			peaks[k] = 0;
+			for ( j = 0; j < link->shards(); j++ ) {
+				peaks[k] = k == MEM_TAGS + 1 ? max(peaks[k], link->memory(j, k)) : peaks[k] + link->memory(j, k);
+			}
+		}
+	}
+
+	fprintf(fp, "Memory peak:");
+	for ( k = 0; k < MEM_TAGS; k++ ) {
+		fprintf(fp, " %s=%ld", Memory::name(k), peaks[k]);
+	}
+	fprintf(fp, " total=%ld per_node=%ld largest_node=%ld\n", peaks[MEM_TAGS], peaks[MEM_TAGS] / par->EN_GPSZ, peaks[MEM_TAGS + 1]);
+}
+
+/**
+ * FUNCTION NAME: forkBranches
+ *
+ * DESCRIPTION: Checkpoint the run by forking one copy-on-write child per scenario branch. Each
+ * 				child moves to its own branch-<name> directory, with a copy of the logs so far,
+ * 				and continues with the events of its branch. The children run in parallel.
+ *
+ * RETURNS:
+ * true in a child or if there are no branches, false in the parent once all children are done
+ */
+bool Application::forkBranches() {
+	int k, status;
+	pid_t pid;
+	vector<pid_t> children;
+
+	if ( scenario->branches() == 0 ) {
+		return true;
+	}
+
+	// Worker threads do not survive a fork, every child starts its own pool
+	delete pool;
+	pool = NULL;
+	fflush(out);
+
+	for ( k = 0; k < scenario->branches(); k++ ) {
+		string dir = par->path(("branch-" + scenario->branchName(k)).c_str());
+		mkdir(dir.c_str(), 0755);
+
+		pid = fork();
+		if ( pid < 0 ) {
+			perror("fork");
+			break;
+		}
+		if ( pid == 0 ) {
+			log->branch(dir.c_str());
+			par->OUTPUT_DIR = dir;
+			scenario->enterBranch(k);
+			if ( par->THREADS > 1 ) {
+				pool = new WorkPool(par->THREADS, [this]() { Memory::bind(&memory); });
+			}
+			fprintf(out, "Branch %s forked at time=%d\n", scenario->branchName(k).c_str(), par->getcurrtime());
+			return true;
+		}
+		children.push_back(pid);
+	}
+
+	for ( k = 0; k < (int)children.size(); k++ ) {
+		waitpid(children[k], &status, 0);
+	}
+	fprintf(out, "Checkpoint at time=%d, %d branches done\n", par->getcurrtime(), (int)children.size());
+	return false;
+}
+
+/**
+ * FUNCTION NAME: isRunning
+ *
+ * DESCRIPTION: True if the ith node was introduced before the current tick and has not failed
+ */
+bool Application::isRunning(int i) {
+	return joinedAt[i] >= 0 && par->getcurrtime() > joinedAt[i] && !down[i];
+}
+
+/**
+ * FUNCTION NAME: quiescent
+ *
+ * DESCRIPTION: True if the scenario has no events left, not even branches still to fork at the
+ * 				checkpoint, no messages are dropped and no partition is in effect, the views of the nodes that are up agree with the ground truth and
+ * 				none of those nodes has news left to spread. Only the heartbeats and probes of a
+ * 				steady group are left then, and the rest of the run would change nothing.
+ */
+bool Application::quiescent(int checkpoint) {
+	if ( !scenario->empty() || (scenario->branches() > 0 && par->globaltime < checkpoint) ) {
+		return false;
+	}
+	// Drops and partitions go on causing false removals however steady the group looks now
+	if ( (par->dropmsg && par->MSG_DROP_PROB > 0) || partitioned ) {
+		return false;
+	}
+	if ( !oracle->converged() ) {
+		return false;
+	}
+	for ( int i = nodesFrom; i < nodesTo; i++ ) {
+		if ( joinedAt[i] >= 0 && !down[i] && !mp1[i]->quiescent() ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * FUNCTION NAME: makeNodes
+ *
+ * DESCRIPTION: Create nodes first to last - 1 in the arena and register them with the network
+ */
+void Application::makeNodes(int first, int last) {
+	mp1.create(first, last, protocol, par, en, log);
+	for ( int i = first; i < last; i++ ) {
+		log->LOG(&(mp1[i]->getMemberNode()->addr), "APP");
+	}
+}
+
+/**
+ * FUNCTION NAME: nodeAddress
+ *
+ * DESCRIPTION: Address of the ith node, also in a process that does not hold it
+ */
+Address Application::nodeAddress(int i) {
+	Address addr;
+	addr.init();
+	*(int *)(&(addr.addr)) = i + 1;
+	*(short *)(&(addr.addr[4])) = 0;
+	return addr;
+}
+
+/**
+ * FUNCTION NAME: startNode
+ *
+ * DESCRIPTION: Introduce the ith node into the distributed system
+ */
+void Application::startNode(int i) {
+	Address addr = nodeAddress(i);
+	down[i] = false;
+	if ( mp1[i] ) {
+		mp1[i]->nodeStart(JOINADDR, par->PORTNUM);
+		if ( out ) {
+			fprintf(out, "%d-th introduced node is assigned with the address: %s\n", i, mp1[i]->getMemberNode()->addr.getAddress().c_str());
+		}
+	}
+	oracle->nodeStarted(&addr);
+	nodeCount += i;
+}
+
+/**
+ * FUNCTION NAME: runScenario
+ *
+ * DESCRIPTION: Apply the scenario events that are due at the current time.
+ * 				Introductions are picked up by the following mp1Run.
+ */
+void Application::runScenario() {
+	ScenarioEvent ev;
+
+	starting.clear();
+
+	while ( scenario->nextDue(par->getcurrtime(), ev) ) {
+		applyEvent(ev);
+	}
+}
+
+/**
+ * FUNCTION NAME: applyEvent
+ *
+ * DESCRIPTION: Apply one scenario event. Nodes this process does not hold only have their
+ * 				bookkeeping and the oracle updated.
+ */
+void Application::applyEvent(ScenarioEvent &ev) {
+	unsigned int k;
+	int i;
+	int time = par->getcurrtime();
+
+	for ( k = 0; k < ev.nodes.size(); k++ ) {
+		i = ev.nodes[k];
+		Member *node = mp1[i] ? mp1[i]->getMemberNode() : NULL;
+		Address addr = nodeAddress(i);
+		bool up = joinedAt[i] >= 0 && !down[i];
+
+		switch ( ev.type ) {
+		case EV_JOIN:
+		case EV_REJOIN:
+			// Only nodes that are not up can be (re)introduced
+			if ( !up ) {
+				// A restarted node does not see what was sent to it while it was down
+				if ( joinedAt[i] >= 0 && node ) {
+					en->ENdiscard(&addr);
+				}
+				joinedAt[i] = time;
+				starting.push_back(i);
+			}
+			break;
+		case EV_CRASH:
+			if ( up ) {
+				if ( node ) {
+					#ifdef DEBUGLOG
+					log->LOG(&node->addr, "Node failed at time=%d", time);
+					#endif
+					node->bFailed = true;
+				}
+				down[i] = true;
+				oracle->nodeFailed(&addr);
+			}
+			break;
+		case EV_LEAVE:
+			if ( up ) {
+				if ( node ) {
+					#ifdef DEBUGLOG
+					log->LOG(&node->addr, "Node left at time=%d", time);
+					#endif
+					mp1[i]->finishUpThisNode();
+					node->bFailed = true;
+				}
+				down[i] = true;
+				oracle->nodeFailed(&addr);
+			}
+			break;
+		case EV_PARTITION:
+			en->ENpartition(&addr, nextPartition);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if ( ev.type == EV_PARTITION ) {
+		nextPartition++;
+		partitioned = true;
+	}
+	else if ( ev.type == EV_HEAL ) {
+		en->ENheal();
+		partitioned = false;
+	}
+	else if ( ev.type == EV_DROP ) {
+		par->MSG_DROP_PROB = ev.value;
+		par->dropmsg = ev.value > 0;
+	}
+}
+
+/**
+ * FUNCTION NAME: getjoinaddr
+ *
+ * DESCRIPTION: This function returns the address of the coordinator
+ */
+Address Application::getjoinaddr(void){
+	//trace.funcEntry("Application::getjoinaddr");
+    Address joinaddr;
+    joinaddr.init();
+    *(int *)(&(joinaddr.addr))=1;
+    *(short *)(&(joinaddr.addr[4]))=0;
+    //trace.funcExit("Application::getjoinaddr", SUCCESS);
+    return joinaddr;
+}
@@ -0,0 +1,117 @@
+/**********************************
+ * FILE NAME: Application.h
+ *
+ * DESCRIPTION: Header file of all classes pertaining to the Application Layer
+ **********************************/
+
+#ifndef _APPLICATION_H_
+#define _APPLICATION_H_
+
+#include "stdincludes.h"
+#include "Protocol.h"
+#include "Log.h"
+#include "Params.h"
+#include "Member.h"
+#include "EmulNet.h"
+#include "Queue.h"
+#include "WorkPool.h"
+#include "Scenario.h"
+#include "Oracle.h"
+#include "Shard.h"
+#include "NodeArena.h"
+#include "Memory.h"
+
+/*
+ * Macros
+ */
+#define ARGS_COUNT 2
+// What a run with its own directory prints, in that directory
+#define REPORT_FILE "out.txt"
+
+/**
+ * CLASS NAME: Application
+ *
+ * DESCRIPTION: Application layer of the distributed system
+ */
+class Application{
+private:
+	// Address for introduction to the group
+	// Coordinator Node
+	char JOINADDR[30];
+	EmulNet *en;
+    Log *log;
+	// Protocol the nodes run, and the nodes this process steps
+	ProtocolType *protocol;
+	NodeArena mp1;
+	Params *par;
+	WorkPool *pool;
+	Scenario *scenario;
+	Oracle *oracle;
+	// What the nodes of this run allocate
+	Memory memory;
+	// Where the run reports to
+	FILE *out;
+	// Sum of the indices of the nodes introduced so far
+	long nodeCount;
+	// Tick each node was last introduced at, -1 if never
+	vector<int> joinedAt;
+	// Nodes that crashed or left since they were last introduced
+	vector<bool> down;
+	// Node indices this process steps, all of them unless the run is sharded
+	int nodesFrom;
+	int nodesTo;
+	// Sharded run: memory shared with the other processes
+	ShardLink *link;
+	// Most bytes a single node held at a tick boundary
+	long nodePeak;
+	// Tick the run stopped at once it was quiescent, -1 if it ran to the end
+	int quiescentAt;
+	// Messages sent before MEASURE_FROM, -1 until then
+	long sentFrom;
+	// Samples every MEMORY_LOG ticks, if set
+	FILE *memoryLog;
+	// Nodes introduced at the current tick
+	vector<int> starting;
+	// Partition the next PARTITION event creates
+	int nextPartition;
+	// True from a PARTITION event until the next HEAL
+	bool partitioned;
+	// Event driven mode: tick each node is due to wake up at, -1 if none
+	vector<int> wakeAt;
+	// Event driven mode: last tick each node was stepped at
+	vector<int> steppedAt;
+	// Event driven mode: pending wakeups as (time, node index), earliest first
+	priority_queue< pair<int, int>, vector< pair<int, int> >, greater< pair<int, int> > > timers;
+	// Real time mode: held by a node's thread while it steps, and by the driver to change it
+	mutex *nodeLocks;
+	// Real time mode: microseconds each node stepped after its timer was due
+	vector< vector<int> > lateness;
+	bool isRunning(int i);
+	bool quiescent(int checkpoint);
+	bool forkBranches();
+	void makeNodes(int first, int last);
+	Address nodeAddress(int i);
+	void startNode(int i);
+	void applyEvent(ScenarioEvent &ev);
+	void mp1RunParallel();
+	void mp1RunEvents();
+	void runRealtime();
+	void nodeThread(int i);
+	void waitUntil(long micros);
+	void runSharded();
+	void runShard(int shard);
+	void sampleMemory();
+	void reportMemory(FILE *fp);
+	double cpuSeconds();
+public:
+	Application(Params *, const char *outdir = NULL);
+	virtual ~Application();
+	bool forks();
+	Oracle *getOracle();
+	Address getjoinaddr();
+	int run();
+	void mp1Run();
+	void runScenario();
+};
+
+#endif /* _APPLICATION_H__ */
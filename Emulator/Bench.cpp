@@ -0,0 +1,170 @@
+/**********************************
+ * FILE NAME: Bench.cpp
+ *
+ * DESCRIPTION: Definition of the harness the microbenchmarks of MP1Node are run in
+ **********************************/
+
+#include "Bench.h"
+
+long Bench::allocs = 0;
+
+/*
+ * Allocations of the Bench binary, which is linked with -Wl,--wrap=malloc so that the mallocs
+ * of its own objects come through __wrap_malloc
+ */
+extern "C" void *__real_malloc(size_t bytes);
+
+extern "C" void *__wrap_malloc(size_t bytes) {
+	Bench::allocated();
+	return __real_malloc(bytes);
+}
+
+void *operator new(size_t bytes) {
+	Bench::allocated();
+	void *p = __real_malloc(bytes ? bytes : 1);
+	if ( !p ) {
+		throw bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void *p) noexcept {
+	free(p);
+}
+
+void operator delete(void *p, size_t bytes) noexcept {
+	free(p);
+}
+
+/**
+ * Constructor
+ */
+Bench::Bench() {
+	printf("%-32s %8s %10s %14s %10s\n", "function", "size", "calls", "ns/call", "allocs/call");
+}
+
+/**
+ * FUNCTION NAME: allocated
+ *
+ * DESCRIPTION: Count an allocation
+ */
+void Bench::allocated() {
+	allocs++;
+}
+
+/**
+ * FUNCTION NAME: params
+ *
+ * DESCRIPTION: Parameters of a run of a single node at tick 0, with every log off and the other
+ * 				settings at their defaults
+ */
+Params *Bench::params() {
+	Params *par = new Params();
+
+	par->MAX_NNB = 1;
+	par->EN_GPSZ = 1;
+	par->MAX_MSG_SIZE = 4000;
+	par->EN_BUFFSIZE = 30000;
+	par->MSGCOUNT_LOG = 0;
+	par->TEXT_LOG = 0;
+	par->SEED = 1;
+	return par;
+}
+
+/**
+ * FUNCTION NAME: sizes
+ *
+ * DESCRIPTION: List sizes to run at, 10 and up by factors of 10 to largest
+ */
+vector<int> Bench::sizes(int largest) {
+	vector<int> sizes;
+
+	for ( long size = 10; size <= largest; size *= 10 ) {
+		sizes.push_back(size);
+	}
+	return sizes;
+}
+
+/**
+ * FUNCTION NAME: variant
+ *
+ * DESCRIPTION: Set the suffix of the names on the lines printed from now on, empty for none
+ */
+void Bench::variant(const char *suffix) {
+	this->suffix = suffix;
+}
+
+/**
+ * FUNCTION NAME: nanos
+ *
+ * DESCRIPTION: Monotonic clock in ns
+ */
+long Bench::nanos() {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+/**
+ * FUNCTION NAME: report
+ *
+ * DESCRIPTION: Print the line of a function at a size
+ */
+void Bench::report(const char *name, int size, long calls, long ns, long allocs) {
+	printf("%-32s %8d %10ld %14.1f %10.2f\n", (name + suffix).c_str(), size, calls, (double)ns / calls, (double)allocs / calls);
+	fflush(stdout);
+}
+
+/**
+ * FUNCTION NAME: run
+ *
+ * DESCRIPTION: Time a call that leaves the state as it found it, in batches twice as long each
+ * 				time until one takes BENCH_NS
+ */
+void Bench::run(const char *name, int size, function<void()> call) {
+	for ( long calls = 1; ; calls *= 2 ) {
+		long allocsBefore = allocs;
+		long start = nanos();
+		for ( long i = 0; i < calls; i++ ) {
+			call();
+		}
+		long ns = nanos() - start;
+		if ( ns >= BENCH_NS ) {
+			report(name, size, calls, ns, allocs - allocsBefore);
+			return;
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: runEach
+ *
+ * DESCRIPTION: Time a call that uses up the state setup makes for it, timing each call alone
+ * 				until BENCH_NS went by, setups included
+ */
+void Bench::runEach(const char *name, int size, function<void()> setup, function<void()> call) {
+	long calls = 0, ns = 0, callAllocs = 0;
+	long start = nanos();
+
+	do {
+		setup();
+		long allocsBefore = allocs;
+		long callStart = nanos();
+		call();
+		ns += nanos() - callStart;
+		callAllocs += allocs - allocsBefore;
+		calls++;
+	} while ( nanos() - start < BENCH_NS );
+	report(name, size, calls, ns, callAllocs);
+}
+
+/**
+ * FUNCTION NAME: skip
+ *
+ * DESCRIPTION: Note a size a function is not run at
+ */
+void Bench::skip(const char *name, int size) {
+	printf("%-32s %8d %10s %14s %10s\n", (name + suffix).c_str(), size, "-", "-", "-");
+	fflush(stdout);
+}
@@ -0,0 +1,48 @@
+/**********************************
+ * FILE NAME: Bench.h
+ *
+ * DESCRIPTION: Header file of the harness the microbenchmarks of MP1Node are run in
+ **********************************/
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include "stdincludes.h"
+#include "Params.h"
+#include <functional>
+
+/*
+ * Macros
+ */
+// Nanoseconds each function is run for at each size, it is called at least once
+#define BENCH_NS 200000000L
+// Step between the members looked up one after the other, prime to every size
+#define BENCH_STRIDE 7919
+// Sizes above this are skipped for functions whose cost grows with the square of the size
+#define BENCH_QUADRATIC_MAX 10000
+
+/**
+ * CLASS NAME: Bench
+ *
+ * DESCRIPTION: Times a function over and over and prints its ns and allocations per call. The
+ * 				Bench binary counts every operator new, and every malloc of its own objects, as
+ * 				one allocation.
+ */
+class Bench {
+private:
+	static long allocs;
+	string suffix;
+	long nanos();
+	void report(const char *name, int size, long calls, long ns, long allocs);
+public:
+	Bench();
+	static void allocated();
+	static Params *params();
+	static vector<int> sizes(int largest);
+	void variant(const char *suffix);
+	void run(const char *name, int size, function<void()> call);
+	void runEach(const char *name, int size, function<void()> setup, function<void()> call);
+	void skip(const char *name, int size);
+};
+
+#endif /* _BENCH_H_ */
@@ -0,0 +1,282 @@
+/**********************************
+ * FILE NAME: Check.cpp
+ *
+ * DESCRIPTION: Checks of the emulator parts whose mistakes a run would not show right away: the
+ * 				timing wheel, the node lists of the scenario and the intervals of an estimate.
+ * 				Build and run with make check; it prints one line per check and fails if any does.
+ **********************************/
+
+#include "TimerWheel.h"
+#include "Scenario.h"
+#include "Ratio.h"
+
+/*
+ * Macros
+ */
+// Normal quantile of a 95% interval, and how close a computed bound has to be
+#define CHECK_Z 1.959964
+#define CHECK_EPSILON 1e-6
+
+int failed = 0;
+
+/**
+ * FUNCTION NAME: check
+ *
+ * DESCRIPTION: Print the line of a check and count it if it failed
+ */
+void check(const char *what, bool ok) {
+	printf("%-56s %s\n", what, ok ? "ok" : "FAILED");
+	if ( !ok ) {
+		failed++;
+	}
+}
+
+/**
+ * FUNCTION NAME: turn
+ *
+ * DESCRIPTION: Turn the wheel to tick now, as expire() does, and say if exactly the timers of the
+ * 				model due by then fired; those are dropped from the model
+ */
+bool turn(TimerWheel &wheel, map<long, int> &model, int now) {
+	vector<long> fired, expected;
+
+	wheel.expire(now, fired);
+	for ( auto it = model.begin(); it != model.end(); ) {
+		if ( it->second <= now ) {
+			expected.push_back(it->first);
+			it = model.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+	sort(fired.begin(), fired.end());
+	return fired == expected && wheel.size() == (int)model.size();
+}
+
+/**
+ * FUNCTION NAME: stepTo
+ *
+ * DESCRIPTION: Turn the wheel one tick at a time from tick from to tick to, true if every timer
+ * 				fired at its own tick
+ */
+bool stepTo(TimerWheel &wheel, map<long, int> &model, int from, int to) {
+	bool ok = true;
+
+	for ( int tick = from; tick <= to; tick++ ) {
+		ok = turn(wheel, model, tick) && ok;
+	}
+	return ok;
+}
+
+/**
+ * FUNCTION NAME: schedule
+ *
+ * DESCRIPTION: Schedule a timer in the wheel and in the model
+ */
+void schedule(TimerWheel &wheel, map<long, int> &model, long key, int due) {
+	wheel.schedule(key, due);
+	model[key] = due;
+}
+
+/**
+ * FUNCTION NAME: checkTimerWheel
+ *
+ * DESCRIPTION: Timers that share a slot a lap apart, go to the FAR list, move to an earlier tick
+ * 				or into the past, and fire when expire() jumps over many ticks, as it does for the
+ * 				nodes of an EVENT_DRIVEN run
+ */
+void checkTimerWheel() {
+	TimerWheel wheel;
+	map<long, int> model;
+	int top = 1 << (WHEEL_LEVELS * WHEEL_BITS);
+
+	// Timers of the same level 0 slot one lap after another, and once the wheel is past slot 10
+	// one due in it a lap later, wrapping around to the slot of the current tick
+	wheel.reset(0);
+	schedule(wheel, model, 1, 5);
+	schedule(wheel, model, 2, 5 + WHEEL_SLOTS);
+	schedule(wheel, model, 3, 5 + 2 * WHEEL_SLOTS);
+	schedule(wheel, model, 4, 5 + WHEEL_SLOTS * WHEEL_SLOTS);
+	bool ok = stepTo(wheel, model, 0, 10);
+	schedule(wheel, model, 5, 10 + WHEEL_SLOTS - 1);
+	schedule(wheel, model, 6, 10 + WHEEL_SLOTS);
+	check("TimerWheel: timers a lap apart in the same slot", stepTo(wheel, model, 11, 5 + WHEEL_SLOTS * WHEEL_SLOTS) && ok);
+
+	// Beyond the top level, so in the FAR list, and then cascaded down from it
+	wheel.reset(3);
+	schedule(wheel, model, 1, 3 + top);
+	schedule(wheel, model, 2, 3 * top + 7);
+	check("TimerWheel: timers in the FAR list", stepTo(wheel, model, 3, 3 * top + 8));
+
+	// Moved from a high level to a low one, and to a tick expire() already handled
+	wheel.reset(0);
+	schedule(wheel, model, 1, 5000);
+	schedule(wheel, model, 2, 4000);
+	ok = stepTo(wheel, model, 0, 10);
+	schedule(wheel, model, 1, 20);
+	wheel.schedule(2, 3);
+	model[2] = 11;
+	check("TimerWheel: rescheduled to an earlier tick", stepTo(wheel, model, 11, 5001) && ok);
+
+	// A node woken up only when it has work, every expire() jumping to the next one
+	wheel.reset(0);
+	schedule(wheel, model, 1, 7);
+	schedule(wheel, model, 2, 300);
+	schedule(wheel, model, 3, 300);
+	schedule(wheel, model, 4, top + 4464);
+	schedule(wheel, model, 5, 3 * top);
+	ok = turn(wheel, model, 0) && turn(wheel, model, 299) && turn(wheel, model, 300);
+	schedule(wheel, model, 6, top + 16);
+	ok = turn(wheel, model, 100000) && ok;
+	schedule(wheel, model, 7, 100001);
+	check("TimerWheel: expiry jumping many ticks", turn(wheel, model, 250000) && ok);
+
+	// Random schedules, reschedules and cancels against the model, turned by random steps
+	unsigned int seed = 1;
+	int now = 0;
+	wheel.reset(0);
+	ok = true;
+	for ( int op = 0; op < 100000 && ok; op++ ) {
+		long key = rand_r(&seed) % 500;
+		switch ( rand_r(&seed) % 4 ) {
+		case 0:
+			schedule(wheel, model, key, now + rand_r(&seed) % 100);
+			break;
+		case 1:
+			schedule(wheel, model, key, now + rand_r(&seed) % 100000);
+			break;
+		case 2:
+			wheel.cancel(key);
+			model.erase(key);
+			break;
+		default:
+			now += rand_r(&seed) % 2 ? 1 : rand_r(&seed) % 5000;
+			ok = turn(wheel, model, now);
+		}
+	}
+	check("TimerWheel: random operations against a map", ok);
+}
+
+/**
+ * FUNCTION NAME: nodesOf
+ *
+ * DESCRIPTION: Nodes of the events a scenario line leads to over a run of 1000 ticks, sorted,
+ * 				none if the line compiles to no event
+ */
+vector<int> nodesOf(const char *line) {
+	Params *par = new Params();
+	ScenarioEvent ev;
+	vector<int> nodes;
+
+	par->EN_GPSZ = 10;
+	par->TOTAL_TIME = 1000;
+	par->SEED = 1;
+	par->scenario.push_back(line);
+	Scenario *scenario = new Scenario(par);
+	for ( int time = 0; time < par->TOTAL_TIME; time++ ) {
+		while ( scenario->nextDue(time, ev) ) {
+			nodes.insert(nodes.end(), ev.nodes.begin(), ev.nodes.end());
+		}
+	}
+	delete scenario;
+	delete par;
+	sort(nodes.begin(), nodes.end());
+	return nodes;
+}
+
+/**
+ * FUNCTION NAME: distinct
+ *
+ * DESCRIPTION: True if a sorted list holds count distinct nodes of a group of 10
+ */
+bool distinct(vector<int> nodes, int count) {
+	return (int)nodes.size() == count && unique(nodes.begin(), nodes.end()) == nodes.end()
+			&& (nodes.empty() || (nodes.front() >= 0 && nodes.back() < 10));
+}
+
+/**
+ * FUNCTION NAME: checkScenario
+ *
+ * DESCRIPTION: The node lists of scenario lines, and lines whose list is bad and get ignored
+ */
+void checkScenario() {
+	check("Scenario: 1-3,5", nodesOf("0 CRASH 1-3,5") == vector<int>({1, 2, 3, 5}));
+	check("Scenario: all", nodesOf("0 CRASH all") == vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+	check("Scenario: random:3", distinct(nodesOf("0 CRASH random:3"), 3));
+	check("Scenario: random:50%", distinct(nodesOf("0 CRASH random:50%"), 5));
+	check("Scenario: random:1% is at least one node", distinct(nodesOf("0 CRASH random:1%"), 1));
+	check("Scenario: random:20 is the whole group", distinct(nodesOf("0 CRASH random:20"), 10));
+	vector<int> churned = nodesOf("0 CHURN all exp:10 exp:10 1");
+	churned.erase(unique(churned.begin(), churned.end()), churned.end());
+	check("Scenario: CHURN all leaves out the introducer", churned == vector<int>({1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+	// Each of these is reported on stderr and ignored
+	const char *bad[] = {"0 CRASH 3-1", "0 CRASH 10", "0 CRASH 1,,2", "0 CRASH x", "0 CHURN 0 exp:10 exp:10 1"};
+	bool ok = true;
+	for ( const char *line: bad ) {
+		ok = nodesOf(line).empty() && ok;
+	}
+	check("Scenario: bad node lists are ignored", ok);
+}
+
+/**
+ * FUNCTION NAME: near
+ *
+ * DESCRIPTION: True if two bounds are equal but for rounding
+ */
+bool near(double a, double b) {
+	return fabs(a - b) <= CHECK_EPSILON * max(1.0, fabs(b));
+}
+
+/**
+ * FUNCTION NAME: checkRatio
+ *
+ * DESCRIPTION: Intervals of the rate estimator with no exposure, no events, one trial, trials
+ * 				that agree and trials that do not, and its stopping rules
+ */
+void checkRatio() {
+	Ratio none, zero, one, same, spread;
+	double low, high;
+
+	none.interval(CHECK_Z, 0.95, low, high);
+	check("Ratio: no exposure is [0, 0]", low == 0 && high == 0);
+
+	zero.add(0, 600);
+	zero.add(0, 400);
+	zero.interval(CHECK_Z, 0.95, low, high);
+	check("Ratio: no events is [0, -ln(0.05) / exposure]", low == 0 && near(high, -log(0.05) / 1000));
+
+	one.add(3, 10);
+	one.interval(CHECK_Z, 0.95, low, high);
+	check("Ratio: one trial has no upper bound", low == 0 && std::isinf(high));
+
+	same.add(1, 10);
+	same.add(2, 20);
+	same.add(3, 30);
+	same.interval(CHECK_Z, 0.95, low, high);
+	check("Ratio: trials that agree give the rate", near(low, 0.1) && near(high, 0.1));
+
+	// Rate 0.2, the trials 1 and 3 off what it predicts for 10: s2 = 2, half width z * 2 / 20
+	spread.add(1, 10);
+	spread.add(3, 10);
+	spread.interval(CHECK_Z, 0.95, low, high);
+	check("Ratio: delta method interval", near(low, 0.2 - CHECK_Z / 10) && near(high, 0.2 + CHECK_Z / 10));
+
+	check("Ratio: precise within the relative error", spread.precise(CHECK_Z, 1, 0.95, 0) && !spread.precise(CHECK_Z, 0.5, 0.95, 0));
+	check("Ratio: no events are precise only below a target", !zero.precise(CHECK_Z, 1, 0.95, 0)
+			&& zero.precise(CHECK_Z, 1, 0.95, 0.003) && !zero.precise(CHECK_Z, 1, 0.95, 0.002));
+}
+
+/**********************************
+ * FUNCTION NAME: main
+ *
+ * DESCRIPTION: Run every check
+ **********************************/
+int main(int argc, char *argv[]) {
+	checkTimerWheel();
+	checkScenario();
+	checkRatio();
+	printf("%d checks failed\n", failed);
+	return failed ? FAILURE : SUCCESS;
+}
@@ -0,0 +1,574 @@
+/**********************************
+ * FILE NAME: EmulNet.cpp
+ *
+ * DESCRIPTION: Emulated Network classes definition
+ **********************************/
+
+#include "EmulNet.h"
+
+/**
+ * Constructor
+ */
+EmulNet::EmulNet(Params *p)
+{
+	//trace.funcEntry("EmulNet::EmulNet");
+	int i;
+	par = p;
+	emulnet.setNextId(1);
+	emulnet.settCurrBuffSize(0);
+	emulnet.buff.resize(par->EN_BUFFSIZE);
+	enInited=0;
+	// Everything is sized from the test case
+	sent_totals.assign(par->EN_GPSZ + 1, 0);
+	recv_totals.assign(par->EN_GPSZ + 1, 0);
+	sent_bytes.assign(par->EN_GPSZ + 1, 0);
+	if ( par->MSGCOUNT_LOG ) {
+		sent_msgs.assign((size_t)(par->EN_GPSZ + 1) * par->TOTAL_TIME, 0);
+		recv_msgs.assign((size_t)(par->EN_GPSZ + 1) * par->TOTAL_TIME, 0);
+	}
+	if ( par->DOUBLE_BUFFER ) {
+		nextgen.resize(par->EN_GPSZ + 1);
+		currgen.resize(par->EN_GPSZ + 1);
+	}
+	partition.assign(par->EN_GPSZ + 1, 0);
+	link = NULL;
+	ownFrom = 1;
+	ownTo = par->EN_GPSZ;
+	dropseed.resize(par->EN_GPSZ + 1);
+	for ( i = 0; i <= par->EN_GPSZ; i++ ) {
+		dropseed[i] = par->SEED + 7919 * i;
+	}
+	if ( par->DROP_BY_LINK ) {
+		linkSent.resize(par->EN_GPSZ + 1);
+		linkTick.assign(par->EN_GPSZ + 1, -1);
+	}
+	//trace.funcExit("EmulNet::EmulNet", SUCCESS);
+}
+
+/**
+ * Copy constructor
+ */
+EmulNet::EmulNet(EmulNet &anotherEmulNet) {
+	this->par = anotherEmulNet.par;
+	this->enInited = anotherEmulNet.enInited;
+	this->sent_msgs = anotherEmulNet.sent_msgs;
+	this->recv_msgs = anotherEmulNet.recv_msgs;
+	this->sent_totals = anotherEmulNet.sent_totals;
+	this->recv_totals = anotherEmulNet.recv_totals;
+	this->sent_bytes = anotherEmulNet.sent_bytes;
+	this->emulnet = anotherEmulNet.emulnet;
+	this->nextgen = anotherEmulNet.nextgen;
+	this->currgen = anotherEmulNet.currgen;
+	this->dropseed = anotherEmulNet.dropseed;
+	this->linkSent = anotherEmulNet.linkSent;
+	this->linkTick = anotherEmulNet.linkTick;
+	this->delivered = anotherEmulNet.delivered;
+	this->partition = anotherEmulNet.partition;
+	this->link = anotherEmulNet.link;
+	this->ownFrom = anotherEmulNet.ownFrom;
+	this->ownTo = anotherEmulNet.ownTo;
+}
+
+/**
+ * Assignment operator overloading
+ */
+EmulNet& EmulNet::operator =(EmulNet &anotherEmulNet) {
+	this->par = anotherEmulNet.par;
+	this->enInited = anotherEmulNet.enInited;
+	this->sent_msgs = anotherEmulNet.sent_msgs;
+	this->recv_msgs = anotherEmulNet.recv_msgs;
+	this->sent_totals = anotherEmulNet.sent_totals;
+	this->recv_totals = anotherEmulNet.recv_totals;
+	this->sent_bytes = anotherEmulNet.sent_bytes;
+	this->emulnet = anotherEmulNet.emulnet;
+	this->nextgen = anotherEmulNet.nextgen;
+	this->currgen = anotherEmulNet.currgen;
+	this->dropseed = anotherEmulNet.dropseed;
+	this->linkSent = anotherEmulNet.linkSent;
+	this->linkTick = anotherEmulNet.linkTick;
+	this->delivered = anotherEmulNet.delivered;
+	this->partition = anotherEmulNet.partition;
+	this->link = anotherEmulNet.link;
+	this->ownFrom = anotherEmulNet.ownFrom;
+	this->ownTo = anotherEmulNet.ownTo;
+	return *this;
+}
+
+/**
+ * Destructor
+ */
+EmulNet::~EmulNet() {}
+
+/**
+ * FUNCTION NAME: ENinit
+ *
+ * DESCRIPTION: Init the emulnet for this node
+ */
+void *EmulNet::ENinit(Address *myaddr, short port) {
+	// Initialize data structures for this member
+	*(int *)(myaddr->addr) = emulnet.nextid++;
+    *(short *)(&myaddr->addr[4]) = 0;
+	return myaddr;
+}
+
+/**
+ * FUNCTION NAME: linkDrop
+ *
+ * DESCRIPTION: Decide whether to drop a message from a hash of the seed, the link, the tick and
+ * 				the number of messages sent on the link earlier in the tick, instead of the
+ * 				sender's random state. Two protocols that send on the same link at the same tick
+ * 				then see the same drops, however many other messages they send.
+ */
+bool EmulNet::linkDrop(int src, int dst) {
+	int time = par->getcurrtime();
+
+	if ( linkTick[src] != time ) {
+		linkSent[src].clear();
+		linkTick[src] = time;
+	}
+	unsigned long long parts[4] = { (unsigned long long)src, (unsigned long long)dst, (unsigned long long)time, (unsigned long long)linkSent[src][dst]++ };
+	unsigned long long h = par->SEED;
+	// One splitmix64 step per part
+	for ( int k = 0; k < 4; k++ ) {
+		h += parts[k] + 0x9e3779b97f4a7c15ULL;
+		h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+		h ^= h >> 31;
+	}
+	return (int)(h % 100) < (int)(par->MSG_DROP_PROB * 100);
+}
+
+/**
+ * FUNCTION NAME: ENsend
+ *
+ * DESCRIPTION: EmulNet send function
+ *
+ * RETURNS:
+ * size
+ */
+int EmulNet::ENsend(Address *myaddr, Address *toaddr, char *data, int size) {
+	en_msg *em;
+	char temp[2048];
+	int src = *(int *)(myaddr->addr);
+	int dst = *(int *)(toaddr->addr);
+	unique_lock<mutex> guard(netLock, defer_lock);
+	if ( par->REALTIME ) {
+		guard.lock();
+	}
+
+	int sendmsg = rand_r(&dropseed[src]) % 100;
+	bool drop = par->DROP_BY_LINK ? linkDrop(src, dst) : sendmsg < (int) (par->MSG_DROP_PROB * 100);
+	int buffsize = par->DOUBLE_BUFFER ? (int)nextgen[src].size() : emulnet.currbuffsize;
+
+	if ( dst > 0 && dst < (int)partition.size() && partition[src] != partition[dst] ) {
+		return 0;
+	}
+
+	if( (buffsize >= par->EN_BUFFSIZE) || (size + (int)sizeof(en_msg) >= par->MAX_MSG_SIZE) || (par->dropmsg && drop) ) {
+		return 0;
+	}
+
+	em = (en_msg *)malloc(sizeof(en_msg) + size);
+	em->size = size;
+	Memory::add(MEM_MESSAGES, sizeof(en_msg) + size);
+
+	memcpy(&(em->from.addr), &(myaddr->addr), sizeof(em->from.addr));
+	memcpy(&(em->to.addr), &(toaddr->addr), sizeof(em->from.addr));
+	memcpy((void *)(em + 1), data, size);
+
+	if ( par->DOUBLE_BUFFER ) {
+		// Only the sender touches its outbox, so concurrent senders need no locking
+		nextgen[src].push_back(em);
+	}
+	else {
+		emulnet.buff[emulnet.currbuffsize++] = em;
+	}
+
+	int time = par->getcurrtime();
+
+	assert(src <= par->EN_GPSZ);
+	assert(time < par->TOTAL_TIME);
+
+	sent_totals[src]++;
+	sent_bytes[src] += size;
+	if ( !sent_msgs.empty() ) {
+		sent_msgs[(size_t)src * par->TOTAL_TIME + time]++;
+	}
+
+	#ifdef DEBUGLOG
+		sprintf(temp, "Sending 4+%d B msg type %d to %d.%d.%d.%d:%d ", size-4, *(int *)data, toaddr->addr[0], toaddr->addr[1], toaddr->addr[2], toaddr->addr[3], *(short *)&toaddr->addr[4]);
+	#endif
+
+	return size;
+}
+
+/**
+ * FUNCTION NAME: ENsend
+ *
+ * DESCRIPTION: EmulNet send function
+ *
+ * RETURNS:
+ * size
+ */
+int EmulNet::ENsend(Address *myaddr, Address *toaddr, string data) {
+	char * str = (char *) malloc(data.length() * sizeof(char));
+	memcpy(str, data.c_str(), data.size());
+	int ret = this->ENsend(myaddr, toaddr, str, (data.length() * sizeof(char)));
+	free(str);
+	return ret;
+}
+
+/**
+ * FUNCTION NAME: ENrecv
+ *
+ * DESCRIPTION: EmulNet receive function
+ *
+ * RETURN:
+ * 0
+ */
+int EmulNet::ENrecv(Address *myaddr, int (* enq)(void *, char *, int), struct timeval *t, int times, void *queue){
+	// times is always assumed to be 1
+	int i;
+	char* tmp;
+	int sz;
+	en_msg *emsg;
+	unique_lock<mutex> guard(netLock, defer_lock);
+
+	if ( par->REALTIME ) {
+		guard.lock();
+	}
+
+	if ( par->DOUBLE_BUFFER ) {
+		int dst = *(int *)(myaddr->addr);
+		int time = par->getcurrtime();
+		MessageList &inbox = currgen[dst];
+
+		assert(dst <= par->EN_GPSZ);
+		assert(time < par->TOTAL_TIME);
+
+		// Only messages sent before this tick are visible
+		for( i = 0; i < (int)inbox.size(); i++ ) {
+			emsg = inbox[i];
+			sz = emsg->size;
+			tmp = (char *) malloc(sz * sizeof(char));
+			memcpy(tmp, (char *)(emsg+1), sz);
+			(*enq)(queue, (char *)tmp, sz);
+			freeMessage(emsg);
+			recv_totals[dst]++;
+			if ( !recv_msgs.empty() ) {
+				recv_msgs[(size_t)dst * par->TOTAL_TIME + time]++;
+			}
+		}
+		inbox.clear();
+		return 0;
+	}
+
+	for( i = emulnet.currbuffsize - 1; i >= 0; i-- ) {
+		emsg = emulnet.buff[i];
+
+		if ( 0 == memcmp(emsg->to.addr, myaddr->addr, sizeof(myaddr->addr)) ) {
+			sz = emsg->size;
+			tmp = (char *) malloc(sz * sizeof(char));
+			memcpy(tmp, (char *)(emsg+1), sz);
+
+			emulnet.buff[i] = emulnet.buff[emulnet.currbuffsize-1];
+			emulnet.currbuffsize--;
+
+			(*enq)(queue, (char *)tmp, sz);
+
+			freeMessage(emsg);
+
+			int dst = *(int *)(myaddr->addr);
+			int time = par->getcurrtime();
+
+			assert(dst <= par->EN_GPSZ);
+			assert(time < par->TOTAL_TIME);
+
+			recv_totals[dst]++;
+			if ( !recv_msgs.empty() ) {
+				recv_msgs[(size_t)dst * par->TOTAL_TIME + time]++;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * FUNCTION NAME: ENtick
+ *
+ * DESCRIPTION: Called once at every tick boundary. In double-buffered mode the messages sent
+ * 				during the tick that just ended become the generation that is received during
+ * 				the next one. Outboxes are drained in sender order so the delivery order does not
+ * 				depend on the order the nodes were stepped in.
+ */
+void EmulNet::ENtick() {
+	int src, shard, bytes;
+	unsigned int i;
+	size_t pos;
+	char *msg;
+
+	if ( !par->DOUBLE_BUFFER ) {
+		return;
+	}
+	delivered.clear();
+
+	if ( link == NULL ) {
+		for ( src = 1; src < (int)nextgen.size(); src++ ) {
+			for ( i = 0; i < nextgen[src].size(); i++ ) {
+				deliver(nextgen[src][i]);
+			}
+			nextgen[src].clear();
+		}
+		return;
+	}
+
+	// Sharded run: shards own ascending id ranges, so taking them in order keeps sender order
+	for ( shard = 0; shard < link->shards(); shard++ ) {
+		if ( shard == link->self() ) {
+			for ( src = ownFrom; src <= ownTo; src++ ) {
+				for ( i = 0; i < nextgen[src].size(); i++ ) {
+					deliver(nextgen[src][i]);
+				}
+				nextgen[src].clear();
+			}
+			continue;
+		}
+		pos = 0;
+		while ( (msg = link->next(shard, pos, bytes)) != NULL ) {
+			en_msg *emsg = (en_msg *)malloc(bytes);
+			memcpy((void *)emsg, msg, bytes);
+			Memory::add(MEM_MESSAGES, bytes);
+			deliver(emsg);
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: deliver
+ *
+ * DESCRIPTION: Double-buffered mode: move a message into the inbox of its receiver
+ */
+void EmulNet::deliver(en_msg *emsg) {
+	int dst = *(int *)(emsg->to.addr);
+
+	// Messages that were never picked up stay in the inbox, as in the shared buffer
+	if ( dst > 0 && dst < (int)currgen.size() && (int)currgen[dst].size() < par->EN_BUFFSIZE ) {
+		if ( currgen[dst].empty() ) {
+			delivered.push_back(dst);
+		}
+		currgen[dst].push_back(emsg);
+	}
+	else {
+		freeMessage(emsg);
+	}
+}
+
+/**
+ * FUNCTION NAME: freeMessage
+ *
+ * DESCRIPTION: Free a message the network is done with
+ */
+void EmulNet::freeMessage(en_msg *emsg) {
+	Memory::sub(MEM_MESSAGES, sizeof(en_msg) + emsg->size);
+	free(emsg);
+}
+
+/**
+ * FUNCTION NAME: ENexport
+ *
+ * DESCRIPTION: Sharded run: move the messages of this tick that go to nodes of other shards into
+ * 				the shared queues, which the shard cleared at the start of the tick, before the
+ * 				barrier that lets the other shards read them
+ */
+void EmulNet::ENexport() {
+	int src, dst, shard;
+	unsigned int i, kept;
+	en_msg *emsg;
+
+	for ( src = ownFrom; src <= ownTo; src++ ) {
+		kept = 0;
+		for ( i = 0; i < nextgen[src].size(); i++ ) {
+			emsg = nextgen[src][i];
+			dst = *(int *)(emsg->to.addr);
+			shard = link->shardOf(dst);
+			if ( shard < 0 || shard == link->self() ) {
+				nextgen[src][kept++] = emsg;
+				continue;
+			}
+			// A full queue loses the message, like a full network buffer
+			link->put(shard, emsg, sizeof(en_msg) + emsg->size);
+			freeMessage(emsg);
+		}
+		nextgen[src].resize(kept);
+	}
+}
+
+/**
+ * FUNCTION NAME: ENfirstId
+ *
+ * DESCRIPTION: Let ENinit hand out ids from the given one on, for a shard that starts there
+ */
+void EmulNet::ENfirstId(int id) {
+	emulnet.nextid = id;
+}
+
+/**
+ * FUNCTION NAME: ENsetShard
+ *
+ * DESCRIPTION: Make this the network of the shard the process was attached to
+ */
+void EmulNet::ENsetShard(ShardLink *link) {
+	this->link = link;
+	ownFrom = link->first(link->self()) + 1;
+	ownTo = link->last(link->self());
+}
+
+/**
+ * FUNCTION NAME: ENdelivered
+ *
+ * DESCRIPTION: Ids of the nodes whose empty inbox received messages at the last tick boundary
+ */
+vector<int> &EmulNet::ENdelivered() {
+	return delivered;
+}
+
+/**
+ * FUNCTION NAME: ENsentBytes
+ *
+ * DESCRIPTION: Number of message bytes accepted by the network so far
+ */
+unsigned long EmulNet::ENsentBytes() {
+	unsigned long total = 0;
+	for ( unsigned int i = 0; i < sent_bytes.size(); i++ ) {
+		total += sent_bytes[i];
+	}
+	return total;
+}
+
+/**
+ * FUNCTION NAME: ENpartition
+ *
+ * DESCRIPTION: Move a node into a partition; group 0 is the main network
+ */
+void EmulNet::ENpartition(Address *addr, int group) {
+	int id = *(int *)(addr->addr);
+	if ( id > 0 && id < (int)partition.size() ) {
+		partition[id] = group;
+	}
+}
+
+/**
+ * FUNCTION NAME: ENheal
+ *
+ * DESCRIPTION: Put every node back into the main network
+ */
+void EmulNet::ENheal() {
+	partition.assign(partition.size(), 0);
+}
+
+/**
+ * FUNCTION NAME: ENdiscard
+ *
+ * DESCRIPTION: Throw away the messages waiting for a node, used when a failed node restarts
+ */
+void EmulNet::ENdiscard(Address *addr) {
+	int i;
+	int id = *(int *)(addr->addr);
+	unique_lock<mutex> guard(netLock, defer_lock);
+
+	if ( par->REALTIME ) {
+		guard.lock();
+	}
+
+	if ( par->DOUBLE_BUFFER ) {
+		if ( id > 0 && id < (int)currgen.size() ) {
+			for ( i = 0; i < (int)currgen[id].size(); i++ ) {
+				freeMessage(currgen[id][i]);
+			}
+			currgen[id].clear();
+		}
+		return;
+	}
+
+	for( i = emulnet.currbuffsize - 1; i >= 0; i-- ) {
+		if ( 0 == memcmp(emulnet.buff[i]->to.addr, addr->addr, sizeof(addr->addr)) ) {
+			freeMessage(emulnet.buff[i]);
+			emulnet.buff[i] = emulnet.buff[emulnet.currbuffsize-1];
+			emulnet.currbuffsize--;
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: ENsentTotal
+ *
+ * DESCRIPTION: Number of messages accepted by the network so far
+ */
+unsigned long EmulNet::ENsentTotal() {
+	unsigned long total = 0;
+	for ( unsigned int i = 0; i < sent_totals.size(); i++ ) {
+		total += sent_totals[i];
+	}
+	return total;
+}
+
+/**
+ * FUNCTION NAME: ENcleanup
+ *
+ * DESCRIPTION: Cleanup the EmulNet. Called exactly once at the end of the program.
+ */
+int EmulNet::ENcleanup() {
+	emulnet.nextid=0;
+	int i, j;
+	int sent, recv;
+
+	while(emulnet.currbuffsize > 0) {
+		freeMessage(emulnet.buff[--emulnet.currbuffsize]);
+	}
+	for ( i = 0; i < (int)nextgen.size(); i++ ) {
+		for ( j = 0; j < (int)nextgen[i].size(); j++ ) {
+			freeMessage(nextgen[i][j]);
+		}
+		nextgen[i].clear();
+	}
+	for ( i = 0; i < (int)currgen.size(); i++ ) {
+		for ( j = 0; j < (int)currgen[i].size(); j++ ) {
+			freeMessage(currgen[i][j]);
+		}
+		currgen[i].clear();
+	}
+
+	if ( par->quiet ) {
+		return 0;
+	}
+	// In a sharded run every shard appends its own nodes, in shard order
+	FILE* file = fopen(par->path(MSGCOUNT_LOG_FILE).c_str(), link == NULL ? "w+" : "a");
+
+	for ( i = ownFrom; i <= ownTo; i++ ) {
+		// Without MSGCOUNT_LOG only the totals are kept
+		if ( !sent_msgs.empty() ) {
+			fprintf(file, "node %3d ", i);
+
+			for (j = 0; j < par->getcurrtime(); j++) {
+
+				sent = sent_msgs[(size_t)i * par->TOTAL_TIME + j];
+				recv = recv_msgs[(size_t)i * par->TOTAL_TIME + j];
+				if (i != 67) {
+					fprintf(file, " (%4d, %4d)", sent, recv);
+					if (j % 10 == 9) {
+						fprintf(file, "\n         ");
+					}
+				}
+				else {
+					fprintf(file, "special %4d %4d %4d\n", j, sent, recv);
+				}
+			}
+			fprintf(file, "\n");
+		}
+		fprintf(file, "node %3d sent_total %6lu  recv_total %6lu\n\n", i, sent_totals[i], recv_totals[i]);
+	}
+
+	fclose(file);
+	return 0;
+}
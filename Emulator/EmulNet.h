@@ -0,0 +1,147 @@
+/**********************************
+ * FILE NAME: EmulNet.h
+ *
+ * DESCRIPTION: Emulated Network classes header file
+ **********************************/
+
+#ifndef _EMULNET_H_
+#define _EMULNET_H_
+
+#include "stdincludes.h"
+#include "Params.h"
+#include "Member.h"
+#include "Shard.h"
+#include <mutex>
+
+using namespace std;
+
+/*
+ * Macros
+ */
+#define MSGCOUNT_LOG_FILE "msgcount.log"
+
+/**
+ * Struct Name: en_msg
+ */
+typedef struct en_msg {
+	// Number of bytes after the class
+	int size;
+	// Source node
+	Address from;
+	// Destination node
+	Address to;
+}en_msg;
+
+// Lists of messages in flight, accounted to the network
+typedef vector<en_msg *, Counted<en_msg *, MEM_MESSAGES> > MessageList;
+// Message counters, accounted as such
+typedef vector<int, Counted<int, MEM_COUNTERS> > CountList;
+typedef map<int, int, less<int>, Counted<pair<const int, int>, MEM_COUNTERS> > LinkCounts;
+typedef vector<unsigned long, Counted<unsigned long, MEM_COUNTERS> > TotalList;
+
+/**
+ * Class Name: EM
+ */
+class EM {
+public:
+	int nextid;
+	int currbuffsize;
+	int firsteltindex;
+	MessageList buff;
+	EM() {}
+	EM& operator = (EM &anotherEM) {
+		this->nextid = anotherEM.getNextId();
+		this->currbuffsize = anotherEM.getCurrBuffSize();
+		this->firsteltindex = anotherEM.getFirstEltIndex();
+		int i = this->currbuffsize;
+		while (i > 0) {
+			this->buff[i] = anotherEM.buff[i];
+			i--;
+		}
+		return *this;
+	}
+	int getNextId() {
+		return nextid;
+	}
+	int getCurrBuffSize() {
+		return currbuffsize;
+	}
+	int getFirstEltIndex() {
+		return firsteltindex;
+	}
+	void setNextId(int nextid) {
+		this->nextid = nextid;
+	}
+	void settCurrBuffSize(int currbuffsize) {
+		this->currbuffsize = currbuffsize;
+	}
+	void setFirstEltIndex(int firsteltindex) {
+		this->firsteltindex = firsteltindex;
+	}
+	virtual ~EM() {}
+};
+
+/**
+ * CLASS NAME: EmulNet
+ *
+ * DESCRIPTION: This class defines an emulated network
+ */
+class EmulNet
+{ 	
+private:
+	Params* par;
+	// Per node and per tick message counts, indexed by id * TOTAL_TIME + time. Only kept with MSGCOUNT_LOG
+	CountList sent_msgs;
+	CountList recv_msgs;
+	// Per node message totals, indexed by id
+	TotalList sent_totals;
+	TotalList recv_totals;
+	// Per node totals of message bytes sent, indexed by id
+	TotalList sent_bytes;
+	int enInited;
+	EM emulnet;
+	// Double-buffered mode: next generation outboxes, indexed by sender id
+	vector<MessageList, Counted<MessageList, MEM_MESSAGES> > nextgen;
+	// Double-buffered mode: current generation inboxes, indexed by receiver id
+	vector<MessageList, Counted<MessageList, MEM_MESSAGES> > currgen;
+	// Random state for message drops, one per sender so that drops do not depend on thread timing
+	vector<unsigned int> dropseed;
+	// DROP_BY_LINK: messages each sender sent to each destination at the tick in linkTick
+	vector<LinkCounts> linkSent;
+	vector<int> linkTick;
+	// Double-buffered mode: receivers that got new messages at the last tick boundary
+	vector<int> delivered;
+	// Partition each node id is in; messages only flow within a partition
+	vector<int> partition;
+	// Real time mode: guards the shared buffer and the counters against the node threads
+	mutex netLock;
+	// Sharded run: link to the other shards, and the ids of the nodes this process owns
+	ShardLink *link;
+	int ownFrom;
+	int ownTo;
+	void deliver(en_msg *emsg);
+	void freeMessage(en_msg *emsg);
+	bool linkDrop(int src, int dst);
+public:
+ 	EmulNet(Params *p);
+ 	EmulNet(EmulNet &anotherEmulNet);
+ 	EmulNet& operator = (EmulNet &anotherEmulNet);
+ 	virtual ~EmulNet();
+	void *ENinit(Address *myaddr, short port);
+	int ENsend(Address *myaddr, Address *toaddr, string data);
+	int ENsend(Address *myaddr, Address *toaddr, char *data, int size);
+	int ENrecv(Address *myaddr, int (* enq)(void *, char *, int), struct timeval *t, int times, void *queue);
+	void ENtick();
+	vector<int> &ENdelivered();
+	unsigned long ENsentTotal();
+	unsigned long ENsentBytes();
+	void ENpartition(Address *addr, int group);
+	void ENheal();
+	void ENdiscard(Address *addr);
+	void ENfirstId(int id);
+	void ENsetShard(ShardLink *link);
+	void ENexport();
+	int ENcleanup();
+};
+
+#endif /* _EMULNET_H_ */
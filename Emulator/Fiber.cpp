@@ -0,0 +1,194 @@
+/**********************************
+ * FILE NAME: Fiber.cpp
+ *
+ * DESCRIPTION: Definition of the coroutine runtime a node's protocol can be written in
+ **********************************/
+
+#include "Fiber.h"
+
+/**
+ * FUNCTION NAME: get_return_object
+ *
+ * DESCRIPTION: The Task handed to the caller of a coroutine
+ */
+Task Task::promise_type::get_return_object() {
+	return Task(coroutine_handle<promise_type>::from_promise(*this));
+}
+
+/**
+ * FUNCTION NAME: operator new
+ *
+ * DESCRIPTION: Allocate a coroutine frame
+ */
+void *Task::promise_type::operator new(size_t bytes) {
+	Memory::add(MEM_FRAMES, bytes);
+	return ::operator new(bytes);
+}
+
+/**
+ * FUNCTION NAME: operator delete
+ *
+ * DESCRIPTION: Free a coroutine frame
+ */
+void Task::promise_type::operator delete(void *frame, size_t bytes) {
+	Memory::sub(MEM_FRAMES, bytes);
+	::operator delete(frame);
+}
+
+/**
+ * Constructors
+ */
+Task::Task(): handle(nullptr) {}
+
+Task::Task(coroutine_handle<promise_type> handle): handle(handle) {}
+
+Task::Task(Task &&other): handle(other.handle) {
+	other.handle = nullptr;
+}
+
+/**
+ * FUNCTION NAME: operator =
+ *
+ * DESCRIPTION: Take over the frame of another Task, destroying the one held so far
+ */
+Task &Task::operator =(Task &&other) {
+	if ( this != &other ) {
+		if ( handle ) {
+			handle.destroy();
+		}
+		handle = other.handle;
+		other.handle = nullptr;
+	}
+	return *this;
+}
+
+/**
+ * Destructor
+ */
+Task::~Task() {
+	if ( handle ) {
+		handle.destroy();
+	}
+}
+
+/**
+ * Constructor
+ */
+Fiber::Wait::Wait(Fiber *fiber, int deadline, bool wakeable): fiber(fiber), deadline(deadline), wakeable(wakeable) {}
+
+/**
+ * FUNCTION NAME: await_ready
+ *
+ * DESCRIPTION: A deadline that already came does not suspend the task
+ */
+bool Fiber::Wait::await_ready() {
+	if ( deadline >= 0 && deadline <= fiber->par->getcurrtime() ) {
+		fiber->woken = false;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * FUNCTION NAME: await_suspend
+ *
+ * DESCRIPTION: Park the task until step() finds it woken or its deadline come
+ */
+void Fiber::Wait::await_suspend(coroutine_handle<> handle) {
+	fiber->waiter = handle;
+	fiber->deadline = deadline;
+	fiber->wakeable = wakeable;
+	fiber->woken = false;
+}
+
+/**
+ * FUNCTION NAME: await_resume
+ *
+ * RETURNS:
+ * true if the task was woken, false if it timed out
+ */
+bool Fiber::Wait::await_resume() {
+	return fiber->woken;
+}
+
+/**
+ * Constructor
+ */
+Fiber::Fiber(Params *par): par(par), waiter(nullptr), deadline(-1), wakeable(false), woken(false) {}
+
+/**
+ * FUNCTION NAME: start
+ *
+ * DESCRIPTION: Hold a task that just ran up to its first co_await, dropping the previous one
+ */
+void Fiber::start(Task &&task) {
+	this->task = move(task);
+}
+
+/**
+ * FUNCTION NAME: stop
+ *
+ * DESCRIPTION: Destroy the task wherever it is suspended
+ */
+void Fiber::stop() {
+	waiter = nullptr;
+	deadline = -1;
+	woken = false;
+	task = Task();
+}
+
+/**
+ * FUNCTION NAME: until
+ *
+ * DESCRIPTION: co_await this to sleep until a tick
+ */
+Fiber::Wait Fiber::until(int tick) {
+	return Wait(this, tick, false);
+}
+
+/**
+ * FUNCTION NAME: event
+ *
+ * DESCRIPTION: co_await this to sleep until woken, or until a tick if deadline is not -1
+ */
+Fiber::Wait Fiber::event(int deadline) {
+	return Wait(this, deadline, true);
+}
+
+/**
+ * FUNCTION NAME: wake
+ *
+ * DESCRIPTION: What the task waits on in event() happened, it resumes at the next step()
+ */
+void Fiber::wake() {
+	if ( waiter && wakeable ) {
+		woken = true;
+	}
+}
+
+/**
+ * FUNCTION NAME: step
+ *
+ * DESCRIPTION: Resume the task if it was woken or its deadline came. It runs up to its next
+ * 				co_await before this returns.
+ */
+void Fiber::step() {
+	if ( !waiter ) {
+		return;
+	}
+	if ( !woken && (deadline < 0 || par->getcurrtime() < deadline) ) {
+		return;
+	}
+	coroutine_handle<> handle = waiter;
+	waiter = nullptr;
+	handle.resume();
+}
+
+/**
+ * FUNCTION NAME: nextWakeup
+ *
+ * DESCRIPTION: Tick the task times out at, -1 if it only resumes when woken or is not suspended
+ */
+int Fiber::nextWakeup() {
+	return waiter ? deadline : -1;
+}
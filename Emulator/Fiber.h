@@ -0,0 +1,97 @@
+/**********************************
+ * FILE NAME: Fiber.h
+ *
+ * DESCRIPTION: Header file of the coroutine runtime a node's protocol can be written in
+ **********************************/
+
+#ifndef _FIBER_H_
+#define _FIBER_H_
+
+#include "stdincludes.h"
+#include "Params.h"
+#include "Memory.h"
+#include <coroutine>
+
+/**
+ * CLASS NAME: Task
+ *
+ * DESCRIPTION: Coroutine a node runs (part of) its protocol in. It starts right away, runs up to
+ * 				its first co_await and owns its frame, which is accounted to MEM_FRAMES.
+ */
+class Task {
+public:
+	class promise_type {
+	public:
+		Task get_return_object();
+		suspend_never initial_suspend() {
+			return {};
+		}
+		suspend_always final_suspend() noexcept {
+			return {};
+		}
+		void return_void() {}
+		void unhandled_exception() {
+			terminate();
+		}
+		static void *operator new(size_t bytes);
+		static void operator delete(void *frame, size_t bytes);
+	};
+	Task();
+	explicit Task(coroutine_handle<promise_type> handle);
+	Task(Task &&other);
+	Task &operator =(Task &&other);
+	~Task();
+private:
+	coroutine_handle<promise_type> handle;
+};
+
+/**
+ * CLASS NAME: Fiber
+ *
+ * DESCRIPTION: Holds the Task of one node and resumes it when what it waits on happened. A task
+ * 				waits on one thing at a time, with co_await on:
+ *
+ * 				  until(t)      the tick t, such as the next protocol period
+ * 				  event(t)      a wake() from the node, e.g. a message it was waiting for came
+ * 				                in, or the tick t if that comes first (-1 for no timeout)
+ *
+ * 				and gets back true if it was woken, false if it timed out. The node calls step()
+ * 				each time it runs, after it handled its messages and woke the task if those were
+ * 				what it waited on. When that is stays up to the application's scheduler: the tick
+ * 				loop, the thread pool or, fed by nextWakeup(), the event queue. A suspended task
+ * 				costs its frame and nothing else.
+ */
+class Fiber {
+public:
+	class Wait {
+	public:
+		Wait(Fiber *fiber, int deadline, bool wakeable);
+		bool await_ready();
+		void await_suspend(coroutine_handle<> handle);
+		bool await_resume();
+	private:
+		Fiber *fiber;
+		int deadline;
+		bool wakeable;
+	};
+	Fiber(Params *par);
+	void start(Task &&task);
+	void stop();
+	Wait until(int tick);
+	Wait event(int deadline = -1);
+	void wake();
+	void step();
+	int nextWakeup();
+private:
+	Params *par;
+	Task task;
+	// Where the task is suspended, null while it runs or once it returned
+	coroutine_handle<> waiter;
+	// Tick the waiter times out at, -1 if none
+	int deadline;
+	// Whether wake() ends the current wait, it does not end an until()
+	bool wakeable;
+	bool woken;
+};
+
+#endif /* _FIBER_H_ */
@@ -0,0 +1,305 @@
+/**********************************
+ * FILE NAME: Log.h
+ *
+ * DESCRIPTION: Log class definition
+ **********************************/
+
+#include "Log.h"
+
+/**
+ * Constructor
+ */
+Log::Log(Params *p) {
+	par = p;
+	firstTime = false;
+	staging = false;
+	staged.resize(par->EN_GPSZ + 1);
+	dbgfp = NULL;
+	statsfp = NULL;
+	numwrites = 0;
+	append = false;
+	oracle = NULL;
+}
+
+/**
+ * Copy constructor
+ */
+Log::Log(const Log &anotherLog) {
+	this->par = anotherLog.par;
+	this->firstTime = anotherLog.firstTime;
+	this->staged = anotherLog.staged;
+	this->staging = anotherLog.staging;
+	// Each Log closes its own files, so a copy opens them again and appends
+	this->dbgfp = NULL;
+	this->statsfp = NULL;
+	this->numwrites = anotherLog.numwrites;
+	this->append = anotherLog.append || anotherLog.dbgfp;
+	this->oracle = anotherLog.oracle;
+}
+
+/**
+ * Assignment Operator Overloading
+ */
+Log& Log::operator = (const Log& anotherLog) {
+	this->par = anotherLog.par;
+	this->firstTime = anotherLog.firstTime;
+	this->staged = anotherLog.staged;
+	this->staging = anotherLog.staging;
+	if ( this != &anotherLog ) {
+		close();
+	}
+	this->dbgfp = NULL;
+	this->statsfp = NULL;
+	this->numwrites = anotherLog.numwrites;
+	this->append = anotherLog.append || anotherLog.dbgfp;
+	this->oracle = anotherLog.oracle;
+	return *this;
+}
+
+/**
+ * Destructor
+ */
+Log::~Log() {
+	close();
+}
+
+/**
+ * FUNCTION NAME: close
+ *
+ * DESCRIPTION: Flush and close dbg.log and stats.log if they are open; a later line opens them
+ * 				again and appends
+ */
+void Log::close() {
+	if ( dbgfp ) {
+		fclose(dbgfp);
+		fclose(statsfp);
+		dbgfp = NULL;
+		statsfp = NULL;
+		append = true;
+	}
+}
+
+/**
+ * FUNCTION NAME: LOG
+ *
+ * DESCRIPTION: Print out to file dbg.log, along with Address of node.
+ */
+void Log::LOG(Address *addr, const char * str, ...) {
+
+	if ( !par->TEXT_LOG ) {
+		return;
+	}
+
+	va_list vararglist;
+	char buffer[30000];
+	char stdstring[30];
+
+	sprintf(stdstring, "%d.%d.%d.%d:%d ", addr->addr[0], addr->addr[1], addr->addr[2], addr->addr[3], *(short *)&addr->addr[4]);
+
+	va_start(vararglist, str);
+	vsprintf(buffer, str, vararglist);
+	va_end(vararglist);
+
+	int id = *(int *)(addr->addr);
+	if ( staging && id > 0 && id < (int)staged.size() ) {
+		// Only this node's thread appends to its own slot
+		staged[id] += stdstring;
+		staged[id] += '\0';
+		staged[id] += buffer;
+		staged[id] += '\0';
+		return;
+	}
+
+	write(stdstring, buffer);
+}
+
+/**
+ * FUNCTION NAME: write
+ *
+ * DESCRIPTION: Write one formatted line to dbg.log or stats.log
+ */
+void Log::write(const char *stdstring, const char *buffer) {
+	unique_lock<mutex> guard(writeLock, defer_lock);
+	if ( par->REALTIME ) {
+		guard.lock();
+	}
+
+	if(dbgfp == NULL){
+		numwrites=0;
+
+		dbgfp = fopen(par->path(DBG_LOG).c_str(), append ? "a" : "w");
+		statsfp = fopen(par->path(STATS_LOG).c_str(), append ? "a" : "w");
+	}
+
+	FILE *fp = dbgfp;
+	FILE *fp2 = statsfp;
+
+	if (!firstTime) {
+		int magicNumber = 0;
+		string magic = MAGIC_NUMBER;
+		int len = magic.length();
+		for ( int i = 0; i < len; i++ ) {
+			magicNumber += (int)magic.at(i);
+		}
+		fprintf(fp, "%x\n", magicNumber);
+		firstTime = true;
+	}
+
+	if(memcmp(buffer, "#STATSLOG#", 10)==0){
+		fprintf(fp2, "\n %s", stdstring);
+		fprintf(fp2, "[%d] ", par->getcurrtime());
+
+		fprintf(fp2, buffer);
+	}
+	else{
+		fprintf(fp, "\n %s", stdstring);
+		fprintf(fp, "[%d] ", par->getcurrtime());
+		fprintf(fp, buffer);
+
+	}
+
+	if(++numwrites >= MAXWRITES){
+		fflush(fp);
+		fflush(fp2);
+		numwrites=0;
+	}
+
+}
+
+/**
+ * FUNCTION NAME: branch
+ *
+ * DESCRIPTION: Called in a process forked off at a checkpoint: copy the logs written so far into
+ * 				dir and close them, so that once the process has moved to dir it keeps appending
+ * 				to its own copy
+ */
+void Log::branch(const char *dir) {
+	const char *logs[2] = {DBG_LOG, STATS_LOG};
+	char path[1024];
+	char buf[65536];
+	size_t n;
+
+	if ( dbgfp == NULL ) {
+		return;
+	}
+	fflush(dbgfp);
+	fflush(statsfp);
+
+	for ( int i = 0; i < 2; i++ ) {
+		FILE *in = fopen(par->path(logs[i]).c_str(), "r");
+		sprintf(path, "%s/%s", dir, logs[i]);
+		FILE *out = fopen(path, "w");
+		while ( in && out && (n = fread(buf, 1, sizeof(buf), in)) > 0 ) {
+			fwrite(buf, 1, n, out);
+		}
+		if ( in ) fclose(in);
+		if ( out ) fclose(out);
+	}
+
+	fclose(dbgfp);
+	fclose(statsfp);
+	dbgfp = NULL;
+	statsfp = NULL;
+	append = true;
+}
+
+/**
+ * FUNCTION NAME: share
+ *
+ * DESCRIPTION: Called before the shards of a sharded run are forked: start the logs, so that
+ * 				every process appends its lines to the same files
+ */
+void Log::share() {
+	if ( !par->TEXT_LOG ) {
+		return;
+	}
+	if ( dbgfp == NULL ) {
+		dbgfp = fopen(par->path(DBG_LOG).c_str(), append ? "a" : "w");
+		statsfp = fopen(par->path(STATS_LOG).c_str(), append ? "a" : "w");
+	}
+	if ( !firstTime ) {
+		int magicNumber = 0;
+		string magic = MAGIC_NUMBER;
+		for ( int i = 0; i < (int)magic.length(); i++ ) {
+			magicNumber += (int)magic.at(i);
+		}
+		fprintf(dbgfp, "%x\n", magicNumber);
+		firstTime = true;
+	}
+	fclose(dbgfp);
+	fclose(statsfp);
+	dbgfp = NULL;
+	statsfp = NULL;
+	append = true;
+}
+
+/**
+ * FUNCTION NAME: setOracle
+ *
+ * DESCRIPTION: Report every membership change to the oracle as well
+ */
+void Log::setOracle(Oracle *o) {
+	oracle = o;
+}
+
+/**
+ * FUNCTION NAME: logNodeAdd
+ *
+ * DESCRIPTION: To Log a node add
+ */
+void Log::logNodeAdd(Address *thisNode, Address *addedAddr) {
+	if ( oracle ) {
+		oracle->nodeAdded(thisNode, addedAddr);
+	}
+	if ( !par->TEXT_LOG ) {
+		return;
+	}
+	char stdstring[100];
+	sprintf(stdstring, "Node %d.%d.%d.%d:%d joined at time %d", addedAddr->addr[0], addedAddr->addr[1], addedAddr->addr[2], addedAddr->addr[3], *(short *)&addedAddr->addr[4], par->getcurrtime());
+    LOG(thisNode, stdstring);
+}
+
+/**
+ * FUNCTION NAME: logNodeRemove
+ *
+ * DESCRIPTION: To log a node remove
+ */
+void Log::logNodeRemove(Address *thisNode, Address *removedAddr) {
+	if ( oracle ) {
+		oracle->nodeRemoved(thisNode, removedAddr);
+	}
+	if ( !par->TEXT_LOG ) {
+		return;
+	}
+	char stdstring[100];
+	sprintf(stdstring, "Node %d.%d.%d.%d:%d removed at time %d", removedAddr->addr[0], removedAddr->addr[1], removedAddr->addr[2], removedAddr->addr[3], *(short *)&removedAddr->addr[4], par->getcurrtime());
+    LOG(thisNode, stdstring);
+}
+
+/**
+ * FUNCTION NAME: stage
+ *
+ * DESCRIPTION: While staging, lines are held per node instead of being written immediately
+ */
+void Log::stage(bool on) {
+	staging = on;
+}
+
+/**
+ * FUNCTION NAME: flush
+ *
+ * DESCRIPTION: Write out the staged lines. Nodes are visited from the highest id down, the same
+ * 				order the serial driver steps them in, so the log does not depend on thread timing.
+ */
+void Log::flush() {
+	for ( int id = (int)staged.size() - 1; id > 0; id-- ) {
+		const char *line = staged[id].c_str();
+		const char *end = line + staged[id].size();
+		while ( line < end ) {
+			const char *buffer = line + strlen(line) + 1;
+			write(line, buffer);
+			line = buffer + strlen(buffer) + 1;
+		}
+		staged[id].clear();
+	}
+}
@@ -10,6 +10,8 @@
 #include "stdincludes.h"
 #include "Params.h"
 #include "Member.h"
+#include "Oracle.h"
+#include <mutex>
 
 /*
  * Macros
@@ -29,6 +31,19 @@ class Log{
 private:
 	Params *par;
 	bool firstTime;
+	// Lines held back per node id while nodes are stepped concurrently
+	vector<string> staged;
+	bool staging;
+	FILE *dbgfp;
+	FILE *statsfp;
+	int numwrites;
+	// Reopen the logs for appending instead of truncating them
+	bool append;
+	// Told about every membership change, if set
+	Oracle *oracle;
+	// Real time mode: node threads write lines one at a time
+	mutex writeLock;
+	void write(const char *stdstring, const char *buffer);
 public:
 	Log(Params *p);
 	Log(const Log &anotherLog);
@@ -37,6 +52,12 @@ public:
 	void LOG(Address *, const char * str, ...);
 	void logNodeAdd(Address *, Address *);
 	void logNodeRemove(Address *, Address *);
+	void stage(bool on);
+	void flush();
+	void branch(const char *dir);
+	void share();
+	void close();
+	void setOracle(Oracle *o);
 };
 
 #endif /* _LOG_H_ */
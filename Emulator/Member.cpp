@@ -45,7 +45,7 @@ MemberListEntry::MemberListEntry(int id, short port, long heartbeat, long timest
 /**
  * Constuctor
  */
-MemberListEntry::MemberListEntry(int id, short port): id(id), port(port) {}
+MemberListEntry::MemberListEntry(int id, short port): id(id), port(port), heartbeat(0), timestamp(0) {}
 
 /**
  * Copy constructor
@@ -141,6 +141,62 @@ void MemberListEntry::settimestamp(long timestamp) {
 	this->timestamp = timestamp;
 }
 
+/**
+ * FUNCTION NAME: empty
+ *
+ * DESCRIPTION: True if no message is waiting
+ */
+bool MessageQueue::empty() {
+	return head == elts.size();
+}
+
+/**
+ * FUNCTION NAME: size
+ *
+ * DESCRIPTION: Number of messages waiting
+ */
+size_t MessageQueue::size() {
+	return elts.size() - head;
+}
+
+/**
+ * FUNCTION NAME: front
+ *
+ * DESCRIPTION: Message that came in first
+ */
+q_elt &MessageQueue::front() {
+	return elts[head];
+}
+
+/**
+ * FUNCTION NAME: push
+ *
+ * DESCRIPTION: Add a message at the back
+ */
+void MessageQueue::push(const q_elt &elt) {
+	elts.push_back(elt);
+}
+
+/**
+ * FUNCTION NAME: pop
+ *
+ * DESCRIPTION: Drop the message at the front; the last one empties the vector for reuse. A queue
+ * 				that takes more than QUEUE_KEEP messages every tick keeps its room, and one whose
+ * 				burst is over goes back to room for QUEUE_KEEP after QUEUE_SHRINK_AFTER small drains
+ */
+void MessageQueue::pop() {
+	if ( ++head == elts.size() ) {
+		smallDrains = elts.size() > QUEUE_KEEP ? 0 : smallDrains + 1;
+		elts.clear();
+		head = 0;
+		if ( elts.capacity() > QUEUE_KEEP && smallDrains >= QUEUE_SHRINK_AFTER ) {
+			decltype(elts) fresh;
+			fresh.reserve(QUEUE_KEEP);
+			elts.swap(fresh);
+		}
+	}
+}
+
 /**
  * Copy Constructor
  */
@@ -175,3 +231,12 @@ Member& Member::operator =(const Member& anotherMember) {
 	this->mp1q = anotherMember.mp1q;
 	return *this;
 }
+
+/**
+ * FUNCTION NAME: bytesUsed
+ *
+ * DESCRIPTION: Bytes held by the membership list and the queue entries of this member
+ */
+long Member::bytesUsed() {
+	return memberList.capacity() * sizeof(MemberListEntry) + mp1q.size() * sizeof(q_elt);
+}
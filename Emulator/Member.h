@@ -8,6 +8,15 @@
 #define MEMBER_H_
 
 #include "stdincludes.h"
+#include "Memory.h"
+
+/*
+ * Macros
+ */
+// Messages a drained queue keeps room for, and drains in a row no larger than that after which it
+// gives back the room of an earlier burst
+#define QUEUE_KEEP 64
+#define QUEUE_SHRINK_AFTER 16
 
 /**
  * CLASS NAME: q_elt
@@ -80,6 +89,31 @@ public:
 	void settimestamp(long timestamp);
 };
 
+// Containers of a member, accounted to their subsystem
+typedef vector<MemberListEntry, Counted<MemberListEntry, MEM_MEMBERLIST> > MemberList;
+
+/**
+ * CLASS NAME: MessageQueue
+ *
+ * DESCRIPTION: Messages delivered to a member, first in first out. A vector read from a head
+ * 				index: an empty queue holds no memory, so a member costs no allocation until it
+ * 				gets a message, and the storage is reused once the queue was drained.
+ */
+class MessageQueue {
+private:
+	vector<q_elt, Counted<q_elt, MEM_QUEUE> > elts;
+	size_t head;
+	// Drains in a row that held at most QUEUE_KEEP messages
+	int smallDrains;
+public:
+	MessageQueue(): head(0), smallDrains(0) {}
+	bool empty();
+	size_t size();
+	q_elt &front();
+	void push(const q_elt &elt);
+	void pop();
+};
+
 /**
  * CLASS NAME: Member
  *
@@ -105,11 +139,11 @@ public:
 	// counter for ping timeout
 	int timeOutCounter;
 	// Membership table
-	vector<MemberListEntry> memberList;
+	MemberList memberList;
 	// My position in the membership table
-	vector<MemberListEntry>::iterator myPos;
+	MemberList::iterator myPos;
 	// Queue for failure detection messages
-	queue<q_elt> mp1q;
+	MessageQueue mp1q;
 	/**
 	 * Constructor
 	 */
@@ -119,6 +153,7 @@ public:
 	// Assignment operator overloading
 	Member& operator =(const Member &anotherMember);
 	virtual ~Member() {}
+	long bytesUsed();
 };
 
 #endif /* MEMBER_H_ */
@@ -0,0 +1,115 @@
+/**********************************
+ * FILE NAME: Memory.cpp
+ *
+ * DESCRIPTION: Definition of the memory accounting per subsystem
+ **********************************/
+
+#include "Memory.h"
+
+thread_local Memory *Memory::bound = NULL;
+
+/**
+ * Constructor
+ */
+Memory::Memory(): total(0), totalPeak(0) {
+	for ( int k = 0; k < MEM_TAGS; k++ ) {
+		current[k] = 0;
+		peak[k] = 0;
+	}
+}
+
+/**
+ * FUNCTION NAME: bind
+ *
+ * DESCRIPTION: Account what the calling thread allocates from now on to memory, NULL for nothing
+ */
+void Memory::bind(Memory *memory) {
+	bound = memory;
+}
+
+/**
+ * FUNCTION NAME: add
+ *
+ * DESCRIPTION: A subsystem took bytes
+ */
+void Memory::add(int tag, long bytes) {
+	Memory *m = bound;
+	if ( m == NULL ) {
+		return;
+	}
+	m->current[tag].fetch_add(bytes, memory_order_relaxed);
+	m->total.fetch_add(bytes, memory_order_relaxed);
+}
+
+/**
+ * FUNCTION NAME: sub
+ *
+ * DESCRIPTION: A subsystem gave bytes back
+ */
+void Memory::sub(int tag, long bytes) {
+	Memory *m = bound;
+	if ( m == NULL ) {
+		return;
+	}
+	m->current[tag].fetch_sub(bytes, memory_order_relaxed);
+	m->total.fetch_sub(bytes, memory_order_relaxed);
+}
+
+/**
+ * FUNCTION NAME: sample
+ *
+ * DESCRIPTION: Raise the peaks to the bytes held now; called at the end of every tick, when no
+ * 				thread steps a node
+ */
+void Memory::sample() {
+	for ( int k = 0; k < MEM_TAGS; k++ ) {
+		peak[k] = max(peak[k], current[k].load(memory_order_relaxed));
+	}
+	totalPeak = max(totalPeak, total.load(memory_order_relaxed));
+}
+
+/**
+ * FUNCTION NAME: bytes
+ *
+ * DESCRIPTION: Bytes a subsystem holds now
+ */
+long Memory::bytes(int tag) {
+	return current[tag].load(memory_order_relaxed);
+}
+
+/**
+ * FUNCTION NAME: peakBytes
+ *
+ * DESCRIPTION: Most bytes a subsystem held at a tick boundary
+ */
+long Memory::peakBytes(int tag) {
+	return peak[tag];
+}
+
+/**
+ * FUNCTION NAME: totalBytes
+ *
+ * DESCRIPTION: Bytes all subsystems hold now
+ */
+long Memory::totalBytes() {
+	return total.load(memory_order_relaxed);
+}
+
+/**
+ * FUNCTION NAME: totalPeakBytes
+ *
+ * DESCRIPTION: Most bytes all subsystems held at a tick boundary
+ */
+long Memory::totalPeakBytes() {
+	return totalPeak;
+}
+
+/**
+ * FUNCTION NAME: name
+ *
+ * DESCRIPTION: Name of a subsystem in the reports
+ */
+const char *Memory::name(int tag) {
+	static const char *names[MEM_TAGS] = {"memberlist", "payload", "queue", "messages", "counters", "frames", "timers"};
+	return names[tag];
+}
@@ -0,0 +1,95 @@
+/**********************************
+ * FILE NAME: Memory.h
+ *
+ * DESCRIPTION: Header file of the memory accounting per subsystem
+ **********************************/
+
+#ifndef _MEMORY_H_
+#define _MEMORY_H_
+
+#include "stdincludes.h"
+#include <atomic>
+
+/*
+ * Macros
+ */
+#define MEMORY_LOG_FILE "memory.log"
+
+/**
+ * Subsystems memory is accounted to
+ */
+enum MemTags {
+	MEM_MEMBERLIST,		// Member::memberList
+	MEM_PAYLOAD,		// piggybacked updates of the protocol
+	MEM_QUEUE,			// Member::mp1q and the received messages waiting in it
+	MEM_MESSAGES,		// en_msg buffers in flight and the network's lists of them
+	MEM_COUNTERS,		// per node and per tick message counts of EmulNet
+	MEM_FRAMES,			// coroutine frames of the nodes' Tasks
+	MEM_TIMERS,			// timing wheels of the protocol timeouts
+	MEM_TAGS
+};
+
+/**
+ * CLASS NAME: Memory
+ *
+ * DESCRIPTION: Bytes currently held and the peak per subsystem, over all nodes of one run. Counted
+ * 				by the Counted allocator and by the code that mallocs message buffers, which do not
+ * 				know the run: add and sub go to the accounting the calling thread is bound to, and
+ * 				are not counted on a thread bound to none. The counters are atomic, so nodes stepped
+ * 				on different threads can allocate at the same time. The peaks are only raised by
+ * 				sample() at tick boundaries, where what is held does not depend on how the threads
+ * 				interleaved, so a seed gives the same peaks for any number of threads.
+ */
+class Memory {
+private:
+	atomic<long> current[MEM_TAGS];
+	long peak[MEM_TAGS];
+	atomic<long> total;
+	long totalPeak;
+	static thread_local Memory *bound;
+public:
+	Memory();
+	Memory(const Memory &anotherMemory) = delete;
+	Memory& operator = (const Memory &anotherMemory) = delete;
+	static void bind(Memory *memory);
+	static void add(int tag, long bytes);
+	static void sub(int tag, long bytes);
+	void sample();
+	long bytes(int tag);
+	long peakBytes(int tag);
+	long totalBytes();
+	long totalPeakBytes();
+	static const char *name(int tag);
+};
+
+/**
+ * CLASS NAME: Counted
+ *
+ * DESCRIPTION: Allocator that accounts what a container holds to one subsystem
+ */
+template <class T, int Tag>
+class Counted {
+public:
+	typedef T value_type;
+	template <class U> struct rebind {
+		typedef Counted<U, Tag> other;
+	};
+	Counted() {}
+	template <class U> Counted(const Counted<U, Tag> &) {}
+	T *allocate(size_t n) {
+		Memory::add(Tag, n * sizeof(T));
+		return (T *)::operator new(n * sizeof(T));
+	}
+	void deallocate(T *p, size_t n) {
+		Memory::sub(Tag, n * sizeof(T));
+		::operator delete(p);
+	}
+	template <class U> bool operator ==(const Counted<U, Tag> &) const {
+		return true;
+	}
+	template <class U> bool operator !=(const Counted<U, Tag> &) const {
+		return false;
+	}
+};
+
+#endif /* _MEMORY_H_ */
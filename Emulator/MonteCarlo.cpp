@@ -0,0 +1,183 @@
+/**********************************
+ * FILE NAME: MonteCarlo.cpp
+ *
+ * DESCRIPTION: Definition of the Monte Carlo estimator of the error rates of a protocol
+ **********************************/
+
+#include "MonteCarlo.h"
+
+/**
+ * Constructor
+ */
+MonteCarlo::MonteCarlo(Params *par, FILE *out): par(par), out(out), trialsLog(NULL), next(0), counted(0), stopped(false) {
+	// Two sided quantile of the normal distribution, by bisection on erfc
+	double lo = 0, hi = 10;
+	double tail = 1 - min(max(par->CONFIDENCE, 0.5), 0.999999);
+	for ( int i = 0; i < 100; i++ ) {
+		double mid = (lo + hi) / 2;
+		if ( erfc(mid / sqrt(2.0)) > tail ) {
+			lo = mid;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	z = (lo + hi) / 2;
+}
+
+/**
+ * Destructor
+ */
+MonteCarlo::~MonteCarlo() {
+	if ( trialsLog ) {
+		fclose(trialsLog);
+	}
+}
+
+/**
+ * FUNCTION NAME: run
+ *
+ * DESCRIPTION: Run the trials and print the estimates
+ */
+int MonteCarlo::run() {
+	struct timeval start, end;
+	vector<thread> threads;
+	double low, high, hour = HOUR_MS / max(par->TICK_MS, 1);
+	int i;
+
+	Scenario scenario(par);
+	if ( par->REALTIME || par->SHARDS > 1 || scenario.branches() > 0 ) {
+		fprintf(stderr, "An estimate needs trials that are reproducible and do not fork: no REALTIME, SHARDS or scenario branches\n");
+		return FAILURE;
+	}
+
+	trials.resize(par->TRIALS);
+	done.assign(par->TRIALS, false);
+	if ( !par->OUTPUT_DIR.empty() ) {
+		mkdir(par->OUTPUT_DIR.c_str(), 0755);
+	}
+	trialsLog = fopen(par->path(TRIALS_LOG).c_str(), "w");
+	if ( trialsLog ) {
+		fprintf(trialsLog, "# trial seed false_removals node_ticks failures missed\n");
+	}
+
+	gettimeofday(&start, NULL);
+	for ( i = 1; i < par->THREADS; i++ ) {
+		threads.push_back(thread(&MonteCarlo::worker, this));
+	}
+	worker();
+	for ( i = 0; i < (int)threads.size(); i++ ) {
+		threads[i].join();
+	}
+	gettimeofday(&end, NULL);
+
+	fprintf(out, "Trials: %d of at most %d, seeds %u to %u, ", counted, par->TRIALS, par->SEED, par->SEED + counted - 1);
+	if ( stopped ) {
+		fprintf(out, "stopped once the %g%% intervals were within %g%% of the rates", 100 * par->CONFIDENCE, 100 * par->REL_ERROR);
+		fprintf(out, "%s\n", falseRate.events() <= 0 || (missedRate.exposure() > 0 && missedRate.events() <= 0) ? ", or the bounds of the rates without events below their targets" : "");
+	}
+	else {
+		fprintf(out, "the %g%% intervals are not yet within %g%% of the rates\n", 100 * par->CONFIDENCE, 100 * par->REL_ERROR);
+	}
+
+	falseRate.interval(z, par->CONFIDENCE, low, high);
+	fprintf(out, "False removals: %.0f in %.0f node-ticks, %.4g per node-hour [%.4g, %.4g]\n",
+			falseRate.events(), falseRate.exposure(), falseRate.rate() * hour, low * hour, high * hour);
+	fprintf(out, "Probability of a false removal per node-hour: %.4g [%.4g, %.4g]\n",
+			1 - exp(-falseRate.rate() * hour), 1 - exp(-low * hour), 1 - exp(-high * hour));
+
+	if ( missedRate.exposure() > 0 ) {
+		missedRate.interval(z, par->CONFIDENCE, low, high);
+		fprintf(out, "Missed detections: %.0f of %.0f failures, %.4g [%.4g, %.4g]\n",
+				missedRate.events(), missedRate.exposure(), missedRate.rate(), low, min(high, 1.0));
+	}
+	else {
+		fprintf(out, "Missed detections: no failures in the scenario\n");
+	}
+
+	double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+	fprintf(out, "Ran %d trials in %.3f s on %d threads\n", next, elapsed, max(par->THREADS, 1));
+	return SUCCESS;
+}
+
+/**
+ * FUNCTION NAME: worker
+ *
+ * DESCRIPTION: Run trials until there are none left to hand out or the estimate is done
+ */
+void MonteCarlo::worker() {
+	Trial trial;
+	int k;
+
+	while ( true ) {
+		{
+			lock_guard<mutex> guard(lock);
+			if ( stopped || next >= par->TRIALS ) {
+				return;
+			}
+			k = next++;
+		}
+		runTrial(k, trial);
+		{
+			lock_guard<mutex> guard(lock);
+			trials[k] = trial;
+			done[k] = true;
+			count();
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: runTrial
+ *
+ * DESCRIPTION: Run the kth trial quietly, with seed SEED + k, on this thread
+ */
+void MonteCarlo::runTrial(int k, Trial &trial) {
+	Params *p = new Params(*par);
+
+	p->SEED = par->SEED + k;
+	p->TRIALS = 0;
+	p->THREADS = 1;
+	p->TEXT_LOG = 0;
+	p->MSGCOUNT_LOG = 0;
+	p->MEMORY_LOG = 0;
+	// A run stopped once quiescent would not count the false removals of its later ticks
+	p->QUIESCENCE = 0;
+	p->quiet = true;
+
+	// The application takes p over
+	Application *app = new Application(p);
+	app->run();
+	Oracle *oracle = app->getOracle();
+	trial.falseRemovals = oracle->falseRemovalCount();
+	trial.nodeTicks = oracle->nodeTicks();
+	trial.failures = oracle->failureCount();
+	trial.missed = oracle->missedCount();
+	delete app;
+}
+
+/**
+ * FUNCTION NAME: count
+ *
+ * DESCRIPTION: Add the trials that are done, in seed order, to the estimate and stop it once it is
+ * 				precise enough. Called with the lock held.
+ */
+void MonteCarlo::count() {
+	double hour = HOUR_MS / max(par->TICK_MS, 1);
+
+	while ( !stopped && counted < par->TRIALS && done[counted] ) {
+		Trial &t = trials[counted];
+		falseRate.add(t.falseRemovals, t.nodeTicks);
+		missedRate.add(t.missed, t.failures);
+		if ( trialsLog ) {
+			fprintf(trialsLog, "%d %u %d %ld %d %d\n", counted, par->SEED + counted, t.falseRemovals, t.nodeTicks, t.failures, t.missed);
+		}
+		counted++;
+
+		// Without failures in the scenario there is no missed detection rate to wait for
+		if ( counted >= par->MIN_TRIALS && falseRate.precise(z, par->REL_ERROR, par->CONFIDENCE, par->FALSE_TARGET / hour)
+				&& (missedRate.exposure() <= 0 || missedRate.precise(z, par->REL_ERROR, par->CONFIDENCE, par->MISSED_TARGET)) ) {
+			stopped = true;
+		}
+	}
+}
@@ -0,0 +1,73 @@
+/**********************************
+ * FILE NAME: MonteCarlo.h
+ *
+ * DESCRIPTION: Header file of the Monte Carlo estimator of the error rates of a protocol
+ **********************************/
+
+#ifndef _MONTECARLO_H_
+#define _MONTECARLO_H_
+
+#include "stdincludes.h"
+#include "Params.h"
+#include "Application.h"
+#include "Ratio.h"
+#include <mutex>
+#include <thread>
+
+/*
+ * Macros
+ */
+#define TRIALS_LOG "trials.log"
+// Milliseconds in the hour the false removal rate is given per
+#define HOUR_MS 3600000.0
+
+/**
+ * CLASS NAME: Trial
+ *
+ * DESCRIPTION: What the oracle counted in one seeded run of the test case
+ */
+class Trial {
+public:
+	int falseRemovals;
+	long nodeTicks;
+	int failures;
+	int missed;
+};
+
+/**
+ * CLASS NAME: MonteCarlo
+ *
+ * DESCRIPTION: Runs seeded trials of a test case (SEED, SEED + 1, ...), THREADS of them at a time
+ * 				with each trial stepping its nodes on one thread, and estimates the rate of false
+ * 				removals per node-hour (an hour being 3600000 / TICK_MS ticks) and the share of
+ * 				failures that were never fully detected, with CONFIDENCE intervals. It stops after
+ * 				TRIALS trials, or once at least MIN_TRIALS are done and both intervals are within
+ * 				REL_ERROR of their rate; a rate with no events yet is precise once its bound is
+ * 				below FALSE_TARGET or MISSED_TARGET, and never without a target. Trials are
+ * 				counted in seed order, so the estimate does not depend on the number of threads.
+ */
+class MonteCarlo {
+private:
+	Params *par;
+	FILE *out;
+	FILE *trialsLog;
+	vector<Trial> trials;
+	vector<bool> done;
+	// Next trial to hand out, and number of trials counted in the estimate
+	int next;
+	int counted;
+	bool stopped;
+	mutex lock;
+	double z;
+	Ratio falseRate;
+	Ratio missedRate;
+	void worker();
+	void runTrial(int k, Trial &trial);
+	void count();
+public:
+	MonteCarlo(Params *par, FILE *out);
+	virtual ~MonteCarlo();
+	int run();
+};
+
+#endif /* _MONTECARLO_H_ */
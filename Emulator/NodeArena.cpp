@@ -0,0 +1,67 @@
+/**********************************
+ * FILE NAME: NodeArena.cpp
+ *
+ * DESCRIPTION: Definition of the block of memory the simulated nodes live in
+ **********************************/
+
+#include "NodeArena.h"
+
+/**
+ * Constructor
+ */
+NodeArena::NodeArena(): block(NULL), stride(0), offset(0), align(1), first(0), last(0) {}
+
+/**
+ * Destructor
+ */
+NodeArena::~NodeArena() {
+	clear();
+}
+
+/**
+ * FUNCTION NAME: create
+ *
+ * DESCRIPTION: Build nodes first to last - 1 in one block, taking their addresses from the
+ * 				network in order, and drop the ones held so far
+ */
+void NodeArena::create(int first, int last, ProtocolType *type, Params *par, EmulNet *en, Log *log) {
+	Address addr;
+
+	clear();
+	if ( last <= first ) {
+		return;
+	}
+	align = max(alignof(Member), type->align);
+	// Member, then the protocol, each slot rounded up to the stricter alignment of the two
+	offset = (sizeof(Member) + align - 1) / align * align;
+	stride = (offset + type->size + align - 1) / align * align;
+	block = (char *)::operator new((size_t)(last - first) * stride, align_val_t(align));
+	nodes.resize(last - first);
+	for ( int i = 0; i < last - first; i++ ) {
+		char *slot = block + (size_t)i * stride;
+		Member *member = new (slot) Member();
+		en->ENinit(&addr, par->PORTNUM);
+		nodes[i] = type->make(slot + offset, member, par, en, log, &addr);
+	}
+	this->first = first;
+	this->last = last;
+}
+
+/**
+ * FUNCTION NAME: clear
+ *
+ * DESCRIPTION: Destroy the nodes and free their block
+ */
+void NodeArena::clear() {
+	for ( int i = 0; i < last - first; i++ ) {
+		nodes[i]->~Protocol();
+		((Member *)(block + (size_t)i * stride))->~Member();
+	}
+	if ( block ) {
+		::operator delete(block, align_val_t(align));
+	}
+	nodes.clear();
+	block = NULL;
+	first = 0;
+	last = 0;
+}
@@ -0,0 +1,48 @@
+/**********************************
+ * FILE NAME: NodeArena.h
+ *
+ * DESCRIPTION: Header file of the block of memory the simulated nodes live in
+ **********************************/
+
+#ifndef _NODEARENA_H_
+#define _NODEARENA_H_
+
+#include "stdincludes.h"
+#include "Params.h"
+#include "Member.h"
+#include "EmulNet.h"
+#include "Log.h"
+#include "Protocol.h"
+
+/**
+ * CLASS NAME: NodeArena
+ *
+ * DESCRIPTION: The nodes a process steps, in one block in node order with each node's Member
+ * 				next to its protocol, built and destroyed in one go. Stepping the nodes in order
+ * 				walks the block from start to end.
+ */
+class NodeArena {
+private:
+	char *block;
+	// Bytes from one node's Member to the next, and from a Member to its protocol
+	size_t stride;
+	size_t offset;
+	size_t align;
+	vector<Protocol *> nodes;
+	// Nodes first to last - 1 are held
+	int first;
+	int last;
+	NodeArena(const NodeArena &other);
+	NodeArena &operator =(const NodeArena &other);
+public:
+	NodeArena();
+	virtual ~NodeArena();
+	void create(int first, int last, ProtocolType *type, Params *par, EmulNet *en, Log *log);
+	void clear();
+	// The ith node, NULL if this process does not hold it
+	Protocol *operator [](int i) {
+		return i >= first && i < last ? nodes[i - first] : NULL;
+	}
+};
+
+#endif /* _NODEARENA_H_ */
@@ -0,0 +1,615 @@
+/**********************************
+ * FILE NAME: Oracle.cpp
+ *
+ * DESCRIPTION: Definition of the in-process grading oracle
+ **********************************/
+
+#include "Oracle.h"
+
+/**
+ * FUNCTION NAME: add
+ *
+ * DESCRIPTION: Add one value to the histogram
+ */
+void Histogram::add(int value) {
+	values.push_back(value);
+	sorted = false;
+}
+
+/**
+ * FUNCTION NAME: count
+ *
+ * DESCRIPTION: Number of values
+ */
+int Histogram::count() {
+	return values.size();
+}
+
+/**
+ * FUNCTION NAME: percentile
+ *
+ * DESCRIPTION: Nearest rank percentile, -1 without values
+ */
+int Histogram::percentile(int p) {
+	if ( values.empty() ) {
+		return -1;
+	}
+	if ( !sorted ) {
+		sort(values.begin(), values.end());
+		sorted = true;
+	}
+	int rank = (values.size() * p + 99) / 100;
+	return values[max(rank, 1) - 1];
+}
+
+/**
+ * FUNCTION NAME: summary
+ *
+ * DESCRIPTION: Print "<name>: n=.. p50=.. p95=.. p99=.. max=.." on one line, just the count
+ * 				without values
+ */
+void Histogram::summary(FILE *fp, const char *name) {
+	if ( values.empty() ) {
+		fprintf(fp, "%s: n=0\n", name);
+		return;
+	}
+	fprintf(fp, "%s: n=%d p50=%d p95=%d p99=%d max=%d\n", name, count(),
+			percentile(50), percentile(95), percentile(99), percentile(100));
+}
+
+/**
+ * FUNCTION NAME: print
+ *
+ * DESCRIPTION: Print the summary line followed by the histogram in equal width buckets
+ */
+void Histogram::print(FILE *fp, const char *name) {
+	summary(fp, name);
+	if ( values.empty() ) {
+		fprintf(fp, "\n");
+		return;
+	}
+
+	int lo = percentile(0), hi = percentile(100);
+	int width = max(1, (hi - lo + HISTOGRAM_BUCKETS) / HISTOGRAM_BUCKETS);
+	vector<int> buckets((hi - lo) / width + 1, 0);
+	int most = 0;
+	for ( unsigned int i = 0; i < values.size(); i++ ) {
+		most = max(most, ++buckets[(values[i] - lo) / width]);
+	}
+	for ( unsigned int b = 0; b < buckets.size(); b++ ) {
+		fprintf(fp, "%6d - %-6d %6d ", lo + (int)b * width, lo + ((int)b + 1) * width - 1, buckets[b]);
+		for ( int i = 0; i < (buckets[b] * 50 + most - 1) / most; i++ ) {
+			fputc('#', fp);
+		}
+		fputc('\n', fp);
+	}
+	fprintf(fp, "\n");
+}
+
+/**
+ * Constructor
+ */
+Oracle::Oracle(Params *par): par(par), live(0), detected(0), falsePositives(0), falseRemovals(0), upTicks(0),
+		viewKnown(0), viewPossible(0), viewStale(0), measuredTicks(0) {
+	startedAt.assign(par->EN_GPSZ + 1, -1);
+	failedAt.assign(par->EN_GPSZ + 1, -1);
+	pending.resize(par->EN_GPSZ + 1);
+	views.resize(par->EN_GPSZ + 1);
+	liveHolders.assign(par->EN_GPSZ + 1, 0);
+	falseSince.resize(par->EN_GPSZ + 1);
+	lastFailure.assign(par->EN_GPSZ + 1, -1);
+	openSpread.assign(par->EN_GPSZ + 1, -1);
+}
+
+/**
+ * Destructor
+ */
+Oracle::~Oracle() {}
+
+/**
+ * FUNCTION NAME: id
+ *
+ * DESCRIPTION: Index of a node address, 0 if it is not one of the nodes
+ */
+int Oracle::id(Address *addr) {
+	int i = *(int *)(addr->addr);
+	return (i > 0 && i <= par->EN_GPSZ) ? i : 0;
+}
+
+/**
+ * FUNCTION NAME: nodeStarted
+ *
+ * DESCRIPTION: A node was introduced, or restarted after failing with an empty list
+ */
+void Oracle::nodeStarted(Address *addr) {
+	int i = id(addr);
+	if ( !i ) {
+		return;
+	}
+	if ( startedAt[i] < 0 || failedAt[i] >= 0 ) {
+		live++;
+	}
+	startedAt[i] = par->getcurrtime();
+	failedAt[i] = -1;
+	// It starts over with an empty list, the Join check included
+	views[i].clear();
+	follow(i, true);
+}
+
+/**
+ * FUNCTION NAME: nodeFailed
+ *
+ * DESCRIPTION: A node crashed or left. Its list stops counting, and the clock starts on its
+ * 				detection.
+ */
+void Oracle::nodeFailed(Address *addr) {
+	int i = id(addr), s;
+	int time = par->getcurrtime();
+	map<int, int>::iterator it;
+
+	if ( !i || failedAt[i] >= 0 ) {
+		return;
+	}
+	failedAt[i] = time;
+	live--;
+	follow(i, false);
+	lastFailure[i] = failures.size();
+	failures.push_back(Failure(i, time));
+
+	// What it thought of the others no longer matters
+	falseSince[i].clear();
+	for ( auto &entry: views[i] ) {
+		if ( entry.second ) {
+			lostHolder(entry.first, time);
+		}
+	}
+
+	// Nodes that had wrongly removed it turned out to be right
+	for ( s = 1; s <= par->EN_GPSZ; s++ ) {
+		it = falseSince[s].find(i);
+		if ( it != falseSince[s].end() ) {
+			falseRemoval.add(time - it->second);
+			falseSince[s].erase(it);
+		}
+	}
+
+	if ( liveHolders[i] == 0 ) {
+		failures.back().full = 0;
+		fullDetection.add(0);
+	}
+}
+
+/**
+ * FUNCTION NAME: follow
+ *
+ * DESCRIPTION: Start following the spread of a node joining or failing, instead of its last one
+ */
+void Oracle::follow(int node, bool join) {
+	openSpread[node] = spreads.size();
+	spreads.push_back(Spread(node, par->getcurrtime(), join));
+}
+
+/**
+ * FUNCTION NAME: sample
+ *
+ * DESCRIPTION: Add a point to the spread if the number of nodes that know changed
+ */
+void Oracle::sample(Spread &spread) {
+	int s = spread.node;
+	int others = live - ((startedAt[s] >= 0 && failedAt[s] < 0) ? 1 : 0);
+	int known = spread.join ? liveHolders[s] : others - liveHolders[s];
+	int n = spread.points.size();
+	int tick = par->getcurrtime() - spread.time;
+
+	if ( n > 0 && spread.points[n - 2] == known && spread.points[n - 1] == others ) {
+		return;
+	}
+	spread.points.push_back(tick);
+	spread.points.push_back(known);
+	spread.points.push_back(others);
+
+	if ( spread.half < 0 && 2 * known >= others ) {
+		spread.half = tick;
+		(spread.join ? joinHalf : failHalf).add(tick);
+	}
+	if ( spread.all < 0 && known >= others ) {
+		spread.all = tick;
+		(spread.join ? joinAll : failAll).add(tick);
+	}
+}
+
+/**
+ * FUNCTION NAME: nodeAdded
+ *
+ * DESCRIPTION: The observer added the subject to its membership list
+ */
+void Oracle::nodeAdded(Address *observer, Address *subject) {
+	int o = id(observer), s = id(subject);
+	if ( o && s && o != s ) {
+		pending[o].push_back(ViewChange(s, par->getcurrtime(), true));
+	}
+}
+
+/**
+ * FUNCTION NAME: nodeRemoved
+ *
+ * DESCRIPTION: The observer removed the subject from its membership list
+ */
+void Oracle::nodeRemoved(Address *observer, Address *subject) {
+	int o = id(observer), s = id(subject);
+	if ( o && s && o != s ) {
+		pending[o].push_back(ViewChange(s, par->getcurrtime(), false));
+	}
+}
+
+/**
+ * FUNCTION NAME: takeChanges
+ *
+ * DESCRIPTION: Sharded run: hand over the view changes of an observer queued this tick
+ */
+void Oracle::takeChanges(int observer, vector<ViewChange> &changes) {
+	changes.clear();
+	changes.swap(pending[observer]);
+}
+
+/**
+ * FUNCTION NAME: addChange
+ *
+ * DESCRIPTION: Sharded run: queue a view change a shard reported
+ */
+void Oracle::addChange(int observer, ViewChange change) {
+	if ( observer > 0 && observer <= par->EN_GPSZ ) {
+		pending[observer].push_back(change);
+	}
+}
+
+/**
+ * FUNCTION NAME: endTick
+ *
+ * DESCRIPTION: Apply the view changes of the tick, observers in id order
+ */
+void Oracle::endTick() {
+	for ( int o = 1; o <= par->EN_GPSZ; o++ ) {
+		for ( unsigned int k = 0; k < pending[o].size(); k++ ) {
+			apply(o, pending[o][k]);
+		}
+		pending[o].clear();
+	}
+	for ( int i = 1; i <= par->EN_GPSZ; i++ ) {
+		if ( openSpread[i] >= 0 ) {
+			sample(spreads[openSpread[i]]);
+		}
+	}
+	// grade and report catch up once the run is over, that is not a tick
+	if ( par->getcurrtime() < par->TOTAL_TIME ) {
+		upTicks += live;
+		if ( par->getcurrtime() >= par->MEASURE_FROM ) {
+			measure();
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: measure
+ *
+ * DESCRIPTION: Add how complete and how stale the lists of the live nodes are at this tick to
+ * 				the steady state figures
+ */
+void Oracle::measure() {
+	for ( int s = 1; s <= par->EN_GPSZ; s++ ) {
+		if ( startedAt[s] < 0 ) {
+			continue;
+		}
+		if ( failedAt[s] < 0 ) {
+			viewKnown += liveHolders[s];
+		}
+		else {
+			viewStale += liveHolders[s];
+		}
+	}
+	viewPossible += (long)live * (live - 1);
+	measuredTicks += live;
+}
+
+/**
+ * FUNCTION NAME: apply
+ *
+ * DESCRIPTION: Apply one view change of the observer
+ */
+void Oracle::apply(int o, ViewChange &change) {
+	int s = change.subject;
+	bool up = startedAt[o] >= 0 && failedAt[o] < 0;
+	map<int, int>::iterator it;
+
+	if ( change.added ) {
+		bool &inView = views[o][s];
+		if ( !inView ) {
+			inView = true;
+			if ( up ) {
+				liveHolders[s]++;
+			}
+		}
+		// A wrongly removed node is back
+		it = falseSince[o].find(s);
+		if ( it != falseSince[o].end() ) {
+			falseRemoval.add(change.time - it->second);
+			falseSince[o].erase(it);
+		}
+		return;
+	}
+
+	if ( failedAt[s] < 0 ) {
+		falsePositives++;
+		if ( up && falseSince[o].find(s) == falseSince[o].end() ) {
+			falseSince[o][s] = change.time;
+			falseRemovals++;
+		}
+	}
+	else {
+		detected++;
+		Failure &f = failures[lastFailure[s]];
+		if ( f.first < 0 ) {
+			f.first = change.time - f.time;
+			firstDetection.add(f.first);
+		}
+	}
+
+	auto seen = views[o].find(s);
+	if ( seen != views[o].end() && seen->second ) {
+		seen->second = false;
+		if ( up ) {
+			lostHolder(s, change.time);
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: lostHolder
+ *
+ * DESCRIPTION: One node that was up and had the subject in its list no longer does; once
+ * 				none is left a failed subject is fully detected
+ */
+void Oracle::lostHolder(int s, int time) {
+	liveHolders[s]--;
+	if ( liveHolders[s] == 0 && failedAt[s] >= 0 ) {
+		Failure &f = failures[lastFailure[s]];
+		if ( f.full < 0 ) {
+			f.full = time - f.time;
+			fullDetection.add(f.full);
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: printGrade
+ *
+ * DESCRIPTION: Print one line in the format of Grader.sh
+ */
+void Oracle::printGrade(FILE *fp, const char *what, int score, int max) {
+	char label[64];
+	int len = sprintf(label, "Checking %s", what);
+	fprintf(fp, "%s", label);
+	for ( ; len < GRADE_COLUMN; len++ ) {
+		fputc('.', fp);
+	}
+	fprintf(fp, "%d/%d\n", score, max);
+}
+
+/**
+ * FUNCTION NAME: grade
+ *
+ * DESCRIPTION: Grade the run the way Grader.sh grades dbg.log, for any group size:
+ * 				Join         every introduced node had every other introduced node in its list
+ * 				             since it last started
+ * 				Completeness no node still up has a node that is still down in its list
+ * 				             (scored in proportion to the failed nodes that are gone)
+ * 				Accuracy     no node was removed while it was up, and at least one failure was
+ * 				             detected; not scored with message drops, as in Grader.sh
+ *
+ * RETURNS:
+ * the total score
+ */
+int Oracle::grade(FILE *fp) {
+	int i, total = 0;
+	int introduced = 0, joined = 0, failed = 0, complete = 0;
+	int joinMax = par->DROP_MSG ? 15 : 10;
+	int completeMax = par->DROP_MSG ? 15 : 10;
+
+	endTick();
+
+	for ( i = 1; i <= par->EN_GPSZ; i++ ) {
+		if ( startedAt[i] >= 0 ) {
+			introduced++;
+		}
+	}
+
+	for ( i = 1; i <= par->EN_GPSZ; i++ ) {
+		if ( startedAt[i] < 0 ) {
+			continue;
+		}
+		if ( (int)views[i].size() >= introduced - 1 ) {
+			joined++;
+		}
+		if ( failedAt[i] >= 0 ) {
+			failed++;
+			if ( liveHolders[i] == 0 ) {
+				complete++;
+			}
+		}
+	}
+
+	int joinScore = (introduced > 0 && joined == introduced) ? joinMax : 0;
+	int completeScore = failed > 0 ? completeMax * complete / failed : completeMax;
+	int accuracyScore = (falsePositives == 0 && (failed == 0 || detected > 0)) ? 10 : 0;
+
+	// Grader.sh counts a passed Join as 15 with message drops but prints it as 10/10
+	if ( joinScore > 0 ) {
+		printGrade(fp, "Join", 10, 10);
+	}
+	else {
+		printGrade(fp, "Join", 0, joinMax);
+	}
+	printGrade(fp, "Completeness", completeScore, completeMax);
+	total = joinScore + completeScore;
+	if ( !par->DROP_MSG ) {
+		printGrade(fp, "Accuracy", accuracyScore, 10);
+		total += accuracyScore;
+	}
+	// The lines above do not add up to it with message drops
+	fprintf(fp, "Grade %d/%d\n", total, joinMax + completeMax + (par->DROP_MSG ? 0 : 10));
+	return total;
+}
+
+/**
+ * FUNCTION NAME: printSpread
+ *
+ * DESCRIPTION: Print the summary lines of the joins or of the failures, and the number of them
+ * 				that never reached every live node
+ */
+void Oracle::printSpread(FILE *fp, const char *name, Histogram &half, Histogram &all, bool join) {
+	char label[64];
+	int events = 0;
+
+	for ( unsigned int k = 0; k < spreads.size(); k++ ) {
+		if ( spreads[k].join == join ) {
+			events++;
+		}
+	}
+	sprintf(label, "%s spread to half", name);
+	half.summary(fp, label);
+	sprintf(label, "%s spread to all", name);
+	all.summary(fp, label);
+	fprintf(fp, "%s events: %d, never known to all: %d\n", name, events, events - all.count());
+}
+
+/**
+ * FUNCTION NAME: report
+ *
+ * DESCRIPTION: Print the detection summary lines to fp and write the histograms and every
+ * 				failure to detection.log. Wrong removals that still stand count up to now.
+ */
+void Oracle::report(FILE *fp) {
+	int o, missed = 0;
+	int time = par->getcurrtime();
+	map<int, int>::iterator it;
+
+	endTick();
+
+	Histogram stillFalse = falseRemoval;
+	for ( o = 1; o <= par->EN_GPSZ; o++ ) {
+		for ( it = falseSince[o].begin(); it != falseSince[o].end(); ++it ) {
+			stillFalse.add(time - it->second);
+		}
+	}
+	for ( unsigned int k = 0; k < failures.size(); k++ ) {
+		if ( failures[k].full < 0 ) {
+			missed++;
+		}
+	}
+
+	firstDetection.summary(fp, "First detection");
+	fullDetection.summary(fp, "Full detection");
+	fprintf(fp, "Failures: %d, not fully detected: %d\n", (int)failures.size(), missed);
+	stillFalse.summary(fp, "False removals");
+	printSpread(fp, "Join", joinHalf, joinAll, true);
+	printSpread(fp, "Failure", failHalf, failAll, false);
+	// Share of the live nodes the lists hold, and share of the entries that are of nodes down
+	fprintf(fp, "Views from time=%d: complete=%.4f stale=%.4f\n", par->MEASURE_FROM,
+			viewPossible > 0 ? (double)viewKnown / viewPossible : 1.0,
+			viewKnown + viewStale > 0 ? (double)viewStale / (viewKnown + viewStale) : 0.0);
+
+	FILE *log = fopen(par->path(DETECTION_LOG).c_str(), "w");
+	if ( log == NULL ) {
+		return;
+	}
+	firstDetection.print(log, "First detection");
+	fullDetection.print(log, "Full detection");
+	stillFalse.print(log, "False removals");
+	fprintf(log, "node failed_at first full\n");
+	for ( unsigned int k = 0; k < failures.size(); k++ ) {
+		fprintf(log, "%d %d %d %d\n", failures[k].node, failures[k].time, failures[k].first, failures[k].full);
+	}
+	fclose(log);
+
+	// One line per join or failure: "<JOIN|FAIL> <node> <time> <tick>:<known>/<live> ..."
+	log = fopen(par->path(INFECTION_LOG).c_str(), "w");
+	if ( log == NULL ) {
+		return;
+	}
+	for ( unsigned int k = 0; k < spreads.size(); k++ ) {
+		Spread &spread = spreads[k];
+		fprintf(log, "%s %d %d", spread.join ? "JOIN" : "FAIL", spread.node, spread.time);
+		for ( unsigned int p = 0; p < spread.points.size(); p += 3 ) {
+			fprintf(log, " %d:%d/%d", spread.points[p], spread.points[p + 1], spread.points[p + 2]);
+		}
+		fputc('\n', log);
+	}
+	fclose(log);
+}
+
+/**
+ * FUNCTION NAME: falseRemovalCount
+ *
+ * DESCRIPTION: Number of times a node that was up removed a live node from its list
+ */
+int Oracle::falseRemovalCount() {
+	return falseRemovals;
+}
+
+/**
+ * FUNCTION NAME: nodeTicks
+ *
+ * DESCRIPTION: Ticks the nodes were up for, summed over the nodes
+ */
+long Oracle::nodeTicks() {
+	return upTicks;
+}
+
+/**
+ * FUNCTION NAME: failureCount
+ *
+ * DESCRIPTION: Number of crashes and leaves
+ */
+int Oracle::failureCount() {
+	return failures.size();
+}
+
+/**
+ * FUNCTION NAME: missedCount
+ *
+ * DESCRIPTION: Number of failures some live node still had in its list at the end
+ */
+int Oracle::missedCount() {
+	int missed = 0;
+	for ( unsigned int k = 0; k < failures.size(); k++ ) {
+		if ( failures[k].full < 0 ) {
+			missed++;
+		}
+	}
+	return missed;
+}
+
+/**
+ * FUNCTION NAME: measuredNodeTicks
+ *
+ * DESCRIPTION: Ticks the nodes were up for from MEASURE_FROM on, summed over the nodes
+ */
+long Oracle::measuredNodeTicks() {
+	return measuredTicks;
+}
+
+/**
+ * FUNCTION NAME: converged
+ *
+ * DESCRIPTION: True if every node that is up is in the list of every other node that is up and
+ * 				no node that is down is in any of them, as of the last endTick()
+ */
+bool Oracle::converged() {
+	for ( int s = 1; s <= par->EN_GPSZ; s++ ) {
+		bool up = startedAt[s] >= 0 && failedAt[s] < 0;
+		if ( liveHolders[s] != (up ? live - 1 : 0) ) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,170 @@
+/**********************************
+ * FILE NAME: Oracle.h
+ *
+ * DESCRIPTION: Header file of the in-process grading oracle
+ **********************************/
+
+#ifndef _ORACLE_H_
+#define _ORACLE_H_
+
+#include "stdincludes.h"
+#include "Params.h"
+#include "Member.h"
+#include <unordered_map>
+
+/*
+ * Macros
+ */
+// width of the "Checking <what>......" column of the grade lines
+#define GRADE_COLUMN 31
+// number of buckets the histograms in detection.log are printed with
+#define HISTOGRAM_BUCKETS 20
+#define DETECTION_LOG "detection.log"
+#define INFECTION_LOG "infection.log"
+
+/**
+ * CLASS NAME: ViewChange
+ *
+ * DESCRIPTION: A node adding another node to its membership list or removing it
+ */
+class ViewChange {
+public:
+	int subject;
+	int time;
+	bool added;
+	ViewChange(int subject, int time, bool added): subject(subject), time(time), added(added) {}
+};
+
+/**
+ * CLASS NAME: Failure
+ *
+ * DESCRIPTION: One node failing, with the ticks until the first and until the last node that was
+ * 				up and had it in its list removed it, -1 until then
+ */
+class Failure {
+public:
+	int node;
+	int time;
+	int first;
+	int full;
+	Failure(int node, int time): node(node), time(time), first(-1), full(-1) {}
+};
+
+/**
+ * CLASS NAME: Spread
+ *
+ * DESCRIPTION: How far news of one node joining or failing got: every tick the number of other
+ * 				live nodes that know about it changed, as (ticks since the event, nodes that know,
+ * 				live nodes) triples. A node knows about a join when the joined node is in its list
+ * 				and about a failure when the failed node is not.
+ */
+class Spread {
+public:
+	int node;
+	int time;
+	bool join;
+	vector<int> points;
+	// ticks until half and until all of the live nodes knew, -1 until then
+	int half;
+	int all;
+	Spread(int node, int time, bool join): node(node), time(time), join(join), half(-1), all(-1) {}
+};
+
+/**
+ * CLASS NAME: Histogram
+ *
+ * DESCRIPTION: Distribution of tick counts
+ */
+class Histogram {
+private:
+	vector<int> values;
+	bool sorted;
+public:
+	Histogram(): sorted(true) {}
+	void add(int value);
+	int count();
+	int percentile(int p);
+	void summary(FILE *fp, const char *name);
+	void print(FILE *fp, const char *name);
+};
+
+/**
+ * CLASS NAME: Oracle
+ *
+ * DESCRIPTION: Keeps the ground truth of which nodes are up next to what every node's membership
+ * 				list says, as the Application and the Log report it. It grades the run with the
+ * 				Join, Completeness and Accuracy checks of Grader.sh without reading dbg.log and
+ * 				measures how long failures take to be detected and how long live nodes stay
+ * 				wrongly removed. Nodes are indexed by id.
+ *
+ * 				logNodeAdd/logNodeRemove only queue the change on the observer's own list, so nodes
+ * 				stepped on different threads share nothing; endTick() applies the queues in id
+ * 				order once the tick is over.
+ */
+class Oracle {
+private:
+	Params *par;
+	// Ground truth, only changed between the phases of a tick
+	vector<int> startedAt;
+	vector<int> failedAt;
+	// View changes of the current tick, per observer
+	vector< vector<ViewChange> > pending;
+	// Per observer, every node it has had in its list since it started, mapped to whether it
+	// still has it; only the nodes it heard of take room
+	vector< unordered_map<int, bool> > views;
+	// Number of nodes that are up and have the node in their list
+	vector<int> liveHolders;
+	// Per observer, live nodes it removed and the time it did
+	vector< map<int, int> > falseSince;
+	vector<Failure> failures;
+	// Index in failures of the last failure of every node, -1 if none
+	vector<int> lastFailure;
+	// Nodes up now
+	int live;
+	// Spread of every join and failure, and the index of the one still followed per node
+	vector<Spread> spreads;
+	vector<int> openSpread;
+	int detected;
+	int falsePositives;
+	// Live nodes removed by live nodes, and ticks nodes were up for, summed over the nodes
+	int falseRemovals;
+	long upTicks;
+	// From MEASURE_FROM on, summed over the ticks: entries of live nodes in live nodes' lists,
+	// entries there could have been, entries of nodes that are down, and live nodes
+	long viewKnown;
+	long viewPossible;
+	long viewStale;
+	long measuredTicks;
+	Histogram firstDetection;
+	Histogram fullDetection;
+	Histogram falseRemoval;
+	Histogram joinHalf, joinAll, failHalf, failAll;
+	int id(Address *addr);
+	void apply(int observer, ViewChange &change);
+	void lostHolder(int subject, int time);
+	void follow(int node, bool join);
+	void sample(Spread &spread);
+	void measure();
+	void printSpread(FILE *fp, const char *name, Histogram &half, Histogram &all, bool join);
+	void printGrade(FILE *fp, const char *what, int score, int max);
+public:
+	Oracle(Params *par);
+	virtual ~Oracle();
+	void nodeStarted(Address *addr);
+	void nodeFailed(Address *addr);
+	void nodeAdded(Address *observer, Address *subject);
+	void nodeRemoved(Address *observer, Address *subject);
+	void endTick();
+	void takeChanges(int observer, vector<ViewChange> &changes);
+	void addChange(int observer, ViewChange change);
+	int grade(FILE *fp);
+	void report(FILE *fp);
+	int falseRemovalCount();
+	long nodeTicks();
+	int failureCount();
+	int missedCount();
+	bool converged();
+	long measuredNodeTicks();
+};
+
+#endif /* _ORACLE_H_ */
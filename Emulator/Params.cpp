@@ -0,0 +1,275 @@
+/**********************************
+ * FILE NAME: Params.cpp
+ *
+ * DESCRIPTION: Definition of Parameter class
+ **********************************/
+
+#include "Params.h"
+
+/**
+ * Constructor
+ * Every setting starts at its default, the one a test case gets without its line
+ */
+Params::Params(): quiet(false), clockRunning(false), PORTNUM(8001) {
+	MAX_NNB = 0;
+	SINGLE_FAILURE = 0;
+	DROP_MSG = 0;
+	MSG_DROP_PROB = 0;
+	EN_GPSZ = 0;
+	STEP_RATE = .25;
+	DOUBLE_BUFFER = 0;
+	MAX_MSG_SIZE = 0;
+	EN_BUFFSIZE = 0;
+	TOTAL_TIME = 700;
+	MSGCOUNT_LOG = 1;
+	THREADS = 1;
+	EVENT_DRIVEN = 0;
+	SEED = time(NULL);
+	CHECKPOINT = -1;
+	TEXT_LOG = 1;
+	REALTIME = 0;
+	TICK_MS = 10;
+	SHARDS = 1;
+	MEMORY_LOG = 0;
+	PROTOCOL = "";
+	OUTPUT_DIR = "";
+	TRIALS = 0;
+	MIN_TRIALS = 30;
+	CONFIDENCE = 0.95;
+	REL_ERROR = 0.1;
+	FALSE_TARGET = 0;
+	MISSED_TARGET = 0;
+	QUIESCENCE = 0;
+	DROP_BY_LINK = 0;
+	MEASURE_FROM = 0;
+	globaltime = 0;
+	dropmsg = 0;
+	allNodesJoined = 0;
+}
+
+/**
+ * FUNCTION NAME: setparams
+ *
+ * DESCRIPTION: Set the parameters for this test case
+ */
+void Params::setparams(char *config_file) {
+	FILE *fp = fopen(config_file,"r");
+
+	fscanf(fp,"MAX_NNB: %d", &MAX_NNB);
+	fscanf(fp,"\nSINGLE_FAILURE: %d", &SINGLE_FAILURE);
+	fscanf(fp,"\nDROP_MSG: %d", &DROP_MSG);
+	fscanf(fp,"\nMSG_DROP_PROB: %lf", &MSG_DROP_PROB);
+
+
+	// Optional settings follow as "KEY: value" lines, then an optional SCENARIO section
+	char line[256], key[64], value[192];
+	bool inScenario = false;
+	while ( fgets(line, sizeof(line), fp) ) {
+		line[strcspn(line, "\r\n")] = 0;
+		if ( inScenario ) {
+			if ( line[strspn(line, " \t")] != 0 && line[strspn(line, " \t")] != '#' ) {
+				scenario.push_back(line);
+			}
+		}
+		else if ( sscanf(line, " %63[^: ]: %191s", key, value) == 2 ) {
+			setparam(key, value);
+		}
+		else if ( sscanf(line, " %63[^: ]:", key) == 1 && 0 == strcmp(key, "SCENARIO") ) {
+			inScenario = true;
+		}
+	}
+
+	//printf("Parameters of the test case: %d %d %d %lf\n", MAX_NNB, SINGLE_FAILURE, DROP_MSG, MSG_DROP_PROB);
+
+	EN_GPSZ = MAX_NNB;
+	STEP_RATE=.25;
+	// Room for a full membership list and for 30 messages in flight per node
+	if ( MAX_MSG_SIZE <= 0 ) {
+		MAX_MSG_SIZE = max(4000, 64 * EN_GPSZ);
+	}
+	if ( EN_BUFFSIZE <= 0 ) {
+		EN_BUFFSIZE = max(30000, 30 * EN_GPSZ);
+	}
+	globaltime = 0;
+	dropmsg = 0;
+	allNodesJoined = (long)EN_GPSZ * (EN_GPSZ - 1) / 2;
+	// Nodes stepped concurrently or out of order must not see each other's sends within a tick;
+	// the threads of an estimate run whole trials instead
+	if ( (THREADS > 1 && TRIALS <= 0) || EVENT_DRIVEN ) {
+		DOUBLE_BUFFER = 1;
+	}
+	// Real time nodes step on their own threads and deliver at once through the shared buffer
+	if ( REALTIME ) {
+		DOUBLE_BUFFER = 0;
+		THREADS = 1;
+		EVENT_DRIVEN = 0;
+		TICK_MS = max(TICK_MS, 1);
+		SHARDS = 1;
+	}
+	// Shards exchange messages at the tick boundary, so they step like the double-buffered network
+	SHARDS = max(1, min(SHARDS, EN_GPSZ));
+	if ( SHARDS > 1 ) {
+		DOUBLE_BUFFER = 1;
+		THREADS = 1;
+		EVENT_DRIVEN = 0;
+	}
+	fclose(fp);
+	return;
+}
+
+/**
+ * FUNCTION NAME: setparam
+ *
+ * DESCRIPTION: Set one optional parameter from the test case file
+ */
+void Params::setparam(char *key, char *value) {
+	if ( 0 == strcmp(key, "DOUBLE_BUFFER") ) {
+		DOUBLE_BUFFER = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "THREADS") ) {
+		THREADS = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "EVENT_DRIVEN") ) {
+		EVENT_DRIVEN = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "MAX_MSG_SIZE") ) {
+		MAX_MSG_SIZE = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "EN_BUFFSIZE") ) {
+		EN_BUFFSIZE = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "TOTAL_TIME") ) {
+		TOTAL_TIME = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "MSGCOUNT_LOG") ) {
+		MSGCOUNT_LOG = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "SEED") ) {
+		SEED = strtoul(value, NULL, 10);
+	}
+	else if ( 0 == strcmp(key, "CHECKPOINT") ) {
+		CHECKPOINT = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "TEXT_LOG") ) {
+		TEXT_LOG = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "REALTIME") ) {
+		REALTIME = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "TICK_MS") ) {
+		TICK_MS = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "SHARDS") ) {
+		SHARDS = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "MEMORY_LOG") ) {
+		MEMORY_LOG = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "PROTOCOL") ) {
+		PROTOCOL = value;
+	}
+	else if ( 0 == strcmp(key, "OUTPUT_DIR") ) {
+		OUTPUT_DIR = value;
+	}
+	else if ( 0 == strcmp(key, "TRIALS") ) {
+		TRIALS = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "MIN_TRIALS") ) {
+		MIN_TRIALS = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "CONFIDENCE") ) {
+		CONFIDENCE = atof(value);
+	}
+	else if ( 0 == strcmp(key, "REL_ERROR") ) {
+		REL_ERROR = atof(value);
+	}
+	else if ( 0 == strcmp(key, "FALSE_TARGET") ) {
+		FALSE_TARGET = atof(value);
+	}
+	else if ( 0 == strcmp(key, "MISSED_TARGET") ) {
+		MISSED_TARGET = atof(value);
+	}
+	else if ( 0 == strcmp(key, "QUIESCENCE") ) {
+		QUIESCENCE = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "DROP_BY_LINK") ) {
+		DROP_BY_LINK = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "MEASURE_FROM") ) {
+		MEASURE_FROM = atoi(value);
+	}
+	else if ( 0 == strcmp(key, "TREMOVE") || 0 == strcmp(key, "TFAIL") || 0 == strcmp(key, "TPING")
+			|| 0 == strcmp(key, "FORWARD_PINGERS") || 0 == strcmp(key, "NGOSSIPS") ) {
+		constants[key] = atoi(value);
+	}
+	else {
+		fprintf(stderr, "Unknown parameter %s ignored\n", key);
+	}
+}
+
+/**
+ * FUNCTION NAME: constant
+ *
+ * DESCRIPTION: The protocol constant of that name the test case sets, otherwise the given value.
+ * 				A protocol ignores the constants it does not have.
+ */
+int Params::constant(const char *name, int otherwise) {
+	map<string, int>::iterator it = constants.find(name);
+	return it == constants.end() ? otherwise : it->second;
+}
+
+/**
+ * FUNCTION NAME: getcurrtime
+ *
+ * DESCRIPTION: Return time since start of program, in time units.
+ * 				For a 'real' implementation, this return time would be the UTC time.
+ */
+int Params::getcurrtime(){
+	if ( clockRunning ) {
+		// Whole ticks on the monotonic clock, the last tick lasts until the run is stopped
+		return (int)min(clockMicros() / (TICK_MS * 1000L), (long)TOTAL_TIME - 1);
+	}
+    return globaltime;
+}
+
+/**
+ * FUNCTION NAME: startClock
+ *
+ * DESCRIPTION: Real time mode: from now on getcurrtime counts TICK_MS periods of the monotonic clock
+ */
+void Params::startClock() {
+	clock_gettime(CLOCK_MONOTONIC, &clockStart);
+	clockRunning = true;
+}
+
+/**
+ * FUNCTION NAME: stopClock
+ *
+ * DESCRIPTION: Real time mode: the run is over, getcurrtime returns globaltime again
+ */
+void Params::stopClock() {
+	clockRunning = false;
+}
+
+/**
+ * FUNCTION NAME: clockMicros
+ *
+ * DESCRIPTION: Microseconds of the monotonic clock since startClock
+ */
+long Params::clockMicros() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - clockStart.tv_sec) * 1000000L + (now.tv_nsec - clockStart.tv_nsec) / 1000;
+}
+
+/**
+ * FUNCTION NAME: path
+ *
+ * DESCRIPTION: Path of the log file name in OUTPUT_DIR
+ */
+string Params::path(const char *name) {
+	if ( OUTPUT_DIR.empty() ) {
+		return name;
+	}
+	return OUTPUT_DIR + "/" + name;
+}
@@ -0,0 +1,74 @@
+/**********************************
+ * FILE NAME: Params.h
+ *
+ * DESCRIPTION: Header file of Parameter class
+ **********************************/
+
+#ifndef _PARAMS_H_
+#define _PARAMS_H_
+
+#include "stdincludes.h"
+#include "Params.h"
+#include "Member.h"
+
+enum testTYPE { CREATE_TEST, READ_TEST, UPDATE_TEST, DELETE_TEST };
+
+/**
+ * CLASS NAME: Params
+ *
+ * DESCRIPTION: Params class describing the test cases
+ */
+class Params{
+public:
+	int MAX_NNB;                // max number of neighbors
+	int SINGLE_FAILURE;			// single/multi failure
+	double MSG_DROP_PROB;		// message drop probability
+	double STEP_RATE;		    // dictates the rate of insertion
+	int EN_GPSZ;			    // actual number of peers
+	int MAX_MSG_SIZE;
+	int EN_BUFFSIZE;			// messages the network holds at once
+	int TOTAL_TIME;				// ticks to run for
+	int MSGCOUNT_LOG;			// per tick counts in msgcount.log
+	int DROP_MSG;
+	int dropmsg;
+	int globaltime;
+	long allNodesJoined;
+	int DOUBLE_BUFFER;			// double-buffered network mailboxes
+	int THREADS;				// worker threads stepping the nodes
+	int EVENT_DRIVEN;			// only step nodes with messages or due timers
+	unsigned int SEED;			// seed of all random choices
+	int CHECKPOINT;				// tick the scenario branches are forked at
+	int TEXT_LOG;				// write dbg.log and stats.log
+	int REALTIME;				// one thread per node, ticks of TICK_MS wall clock time
+	int TICK_MS;
+	int SHARDS;					// processes the nodes are split over
+	int MEMORY_LOG;				// ticks between the samples in memory.log, 0 for none
+	string PROTOCOL;			// protocol the nodes run, may be left out if the binary has only one
+	string OUTPUT_DIR;			// directory the logs are written to, the working directory if empty
+	int TRIALS;					// estimate error rates over up to this many seeded trials, 0 for one run
+	int MIN_TRIALS;				// trials an estimate runs before it may stop early
+	double CONFIDENCE;			// confidence level of the estimate's intervals
+	double REL_ERROR;			// an estimate stops once every interval is within this share of its rate
+	double FALSE_TARGET;		// false removals per node-hour that a rate with none yet has to be shown below, 0 for none
+	double MISSED_TARGET;		// share of missed failures that a rate with none yet has to be shown below, 0 for none
+	int QUIESCENCE;				// stop the run once nothing is left to happen
+	int DROP_BY_LINK;			// drop decisions depend on the link and the tick, not the sender's traffic
+	int MEASURE_FROM;			// tick the steady state view accuracy and message rate are measured from
+	map<string, int> constants;	// protocol constants set by the test case, e.g. TPING
+	bool quiet;					// print nothing and write no files, for the trials of an estimate
+	bool clockRunning;			// getcurrtime reads the monotonic clock
+	struct timespec clockStart;
+	short PORTNUM;
+	vector<string> scenario;	// lines of the SCENARIO section
+	Params();
+	void setparams(char *);
+	void setparam(char *, char *);
+	int constant(const char *name, int otherwise);
+	int getcurrtime();
+	void startClock();
+	void stopClock();
+	long clockMicros();
+	string path(const char *name);
+};
+
+#endif /* _PARAMS_H_ */
@@ -0,0 +1,77 @@
+/**********************************
+ * FILE NAME: Protocol.cpp
+ *
+ * DESCRIPTION: Definition of the registry of the membership protocols linked in
+ **********************************/
+
+#include "Protocol.h"
+
+/**
+ * FUNCTION NAME: types
+ *
+ * DESCRIPTION: The registered protocols, made on first use so that registrars in any file can
+ * 				add to it while the program starts
+ */
+vector<ProtocolType> &ProtocolRegistry::types() {
+	static vector<ProtocolType> registered;
+	return registered;
+}
+
+/**
+ * FUNCTION NAME: add
+ *
+ * DESCRIPTION: Register a protocol
+ */
+void ProtocolRegistry::add(ProtocolType type) {
+	types().push_back(type);
+}
+
+/**
+ * FUNCTION NAME: find
+ *
+ * DESCRIPTION: The first type of the protocol PROTOCOL names, or of the only one linked in if it
+ * 				is empty, that accepts the test case; NULL if there is no such protocol
+ */
+ProtocolType *ProtocolRegistry::find(Params *par) {
+	vector<ProtocolType> &registered = types();
+	string name = par->PROTOCOL;
+
+	if ( name.empty() ) {
+		for ( unsigned int k = 0; k < registered.size(); k++ ) {
+			if ( registered[k].name != registered[0].name ) {
+				return NULL;
+			}
+		}
+		if ( registered.empty() ) {
+			return NULL;
+		}
+		name = registered[0].name;
+	}
+	for ( unsigned int k = 0; k < registered.size(); k++ ) {
+		if ( registered[k].name == name && registered[k].accepts(par) ) {
+			return &registered[k];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * FUNCTION NAME: names
+ *
+ * DESCRIPTION: Names of the registered protocols, each once, in alphabetical order and separated
+ * 				by commas
+ */
+string ProtocolRegistry::names() {
+	vector<string> sorted;
+	string list;
+
+	for ( unsigned int k = 0; k < types().size(); k++ ) {
+		sorted.push_back(types()[k].name);
+	}
+	sort(sorted.begin(), sorted.end());
+	sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+	for ( unsigned int k = 0; k < sorted.size(); k++ ) {
+		list += (k ? ", " : "") + sorted[k];
+	}
+	return list;
+}
@@ -0,0 +1,91 @@
+/**********************************
+ * FILE NAME: Protocol.h
+ *
+ * DESCRIPTION: Header file of the interface the Application drives a membership protocol through
+ **********************************/
+
+#ifndef _PROTOCOL_H_
+#define _PROTOCOL_H_
+
+#include "stdincludes.h"
+#include "Params.h"
+#include "Member.h"
+#include "EmulNet.h"
+#include "Log.h"
+
+/**
+ * CLASS NAME: Protocol
+ *
+ * DESCRIPTION: One node's membership protocol, as the Application steps it. Every MP1Node
+ * 				implements it and registers itself under its name with a ProtocolRegistrar.
+ */
+class Protocol {
+public:
+	virtual ~Protocol() {}
+	virtual Member *getMemberNode() = 0;
+	virtual void nodeStart(char *servaddrstr, short serverport) = 0;
+	virtual int recvLoop() = 0;
+	virtual void nodeLoop() = 0;
+	virtual int finishUpThisNode() = 0;
+	virtual int nextWakeup() = 0;
+	virtual bool quiescent() = 0;
+	virtual long bytesUsed() = 0;
+};
+
+/**
+ * CLASS NAME: ProtocolType
+ *
+ * DESCRIPTION: A registered protocol: its name, whether it runs a test case with the protocol
+ * 				constants the test case has, the room one of its nodes takes and how to build one
+ * 				in place. A protocol may register several types under its name, one per set of
+ * 				constants it is compiled for.
+ */
+class ProtocolType {
+public:
+	string name;
+	size_t size;
+	size_t align;
+	bool (*accepts)(Params *par);
+	Protocol *(*make)(void *where, Member *member, Params *par, EmulNet *en, Log *log, Address *addr);
+};
+
+/**
+ * CLASS NAME: ProtocolRegistry
+ *
+ * DESCRIPTION: The protocols linked into this binary. The PROTOCOL setting picks one by name,
+ * 				and may be left out when only one is linked in; of the types registered under that
+ * 				name the first that accepts the test case is made.
+ */
+class ProtocolRegistry {
+private:
+	static vector<ProtocolType> &types();
+public:
+	static void add(ProtocolType type);
+	static ProtocolType *find(Params *par);
+	static string names();
+};
+
+/**
+ * CLASS NAME: ProtocolRegistrar
+ *
+ * DESCRIPTION: Registers the Node class under a name when the program starts, as a static
+ * 				object next to the class
+ */
+template <class Node>
+class ProtocolRegistrar {
+public:
+	ProtocolRegistrar(const char *name) {
+		ProtocolType type;
+		type.name = name;
+		type.size = sizeof(Node);
+		type.align = alignof(Node);
+		type.accepts = Node::accepts;
+		type.make = make;
+		ProtocolRegistry::add(type);
+	}
+	static Protocol *make(void *where, Member *member, Params *par, EmulNet *en, Log *log, Address *addr) {
+		return new (where) Node(member, par, en, log, addr);
+	}
+};
+
+#endif /* _PROTOCOL_H_ */
@@ -19,11 +19,17 @@ class Queue {
 public:
 	Queue() {}
 	virtual ~Queue() {}
-	static bool enqueue(queue<q_elt> *queue, void *buffer, int size) {
+	static bool enqueue(MessageQueue *queue, void *buffer, int size) {
 		q_elt element(buffer, size);
-		queue->emplace(element);
+		queue->push(element);
+		Memory::add(MEM_QUEUE, size);
 		return true;
 	}
+	// Free a buffer taken off the queue once it was handled
+	static void release(void *buffer, int size) {
+		free(buffer);
+		Memory::sub(MEM_QUEUE, size);
+	}
 };
 
 #endif /* QUEUE_H_ */
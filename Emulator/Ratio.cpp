@@ -0,0 +1,102 @@
+/**********************************
+ * FILE NAME: Ratio.cpp
+ *
+ * DESCRIPTION: Definition of the ratio estimator behind the rates of an estimate
+ **********************************/
+
+#include "Ratio.h"
+
+/**
+ * Constructor
+ */
+Ratio::Ratio(): n(0), x(0), y(0), xx(0), xy(0), yy(0) {}
+
+/**
+ * FUNCTION NAME: add
+ *
+ * DESCRIPTION: Count the events and the exposure of one more trial
+ */
+void Ratio::add(double events, double exposure) {
+	n++;
+	x += events;
+	y += exposure;
+	xx += events * events;
+	xy += events * exposure;
+	yy += exposure * exposure;
+}
+
+/**
+ * FUNCTION NAME: events
+ *
+ * DESCRIPTION: Events over all trials
+ */
+double Ratio::events() {
+	return x;
+}
+
+/**
+ * FUNCTION NAME: exposure
+ *
+ * DESCRIPTION: Exposure over all trials
+ */
+double Ratio::exposure() {
+	return y;
+}
+
+/**
+ * FUNCTION NAME: rate
+ *
+ * DESCRIPTION: Events per unit of exposure, 0 without exposure
+ */
+double Ratio::rate() {
+	return y > 0 ? x / y : 0;
+}
+
+/**
+ * FUNCTION NAME: interval
+ *
+ * DESCRIPTION: Bounds of the interval that holds the rate with the given confidence, z being the
+ * 				matching quantile of the normal distribution
+ */
+void Ratio::interval(double z, double confidence, double &low, double &high) {
+	double r = rate();
+
+	low = 0;
+	if ( y <= 0 ) {
+		high = 0;
+	}
+	else if ( x <= 0 ) {
+		high = -log(1 - confidence) / y;
+	}
+	else if ( n < 2 ) {
+		high = INFINITY;
+	}
+	else {
+		// Spread of the trials' events around what the rate predicts from their exposure
+		double s2 = max(0.0, xx - 2 * r * xy + r * r * yy) / (n - 1);
+		double half = z * sqrt(s2 * n) / y;
+		low = max(0.0, r - half);
+		high = r + half;
+	}
+}
+
+/**
+ * FUNCTION NAME: precise
+ *
+ * DESCRIPTION: True if there were events and the interval is within relError of the rate, or if
+ * 				there were none and the bound for zero events is below target, a target of 0
+ * 				being none
+ */
+bool Ratio::precise(double z, double relError, double confidence, double target) {
+	double low, high;
+
+	if ( x <= 0 ) {
+		if ( target <= 0 || y <= 0 ) {
+			return false;
+		}
+		interval(z, confidence, low, high);
+		return high <= target;
+	}
+	interval(z, confidence, low, high);
+	return high - rate() <= relError * rate();
+}
@@ -0,0 +1,36 @@
+/**********************************
+ * FILE NAME: Ratio.h
+ *
+ * DESCRIPTION: Header file of the ratio estimator behind the rates of an estimate
+ **********************************/
+
+#ifndef _RATIO_H_
+#define _RATIO_H_
+
+#include "stdincludes.h"
+
+/**
+ * CLASS NAME: Ratio
+ *
+ * DESCRIPTION: Events per unit of exposure over the trials so far, e.g. false removals per
+ * 				node-tick, as the ratio of the totals. Its confidence interval comes from how much
+ * 				the trials vary (the delta method for a ratio estimator), so events that come in
+ * 				bursts within a trial widen it. Without any events the interval is the one sided
+ * 				bound -ln(1 - confidence) / exposure of a Poisson count of 0, and the rate is
+ * 				precise once that bound is below a target rate.
+ */
+class Ratio {
+private:
+	int n;
+	double x, y, xx, xy, yy;
+public:
+	Ratio();
+	void add(double events, double exposure);
+	double events();
+	double exposure();
+	double rate();
+	void interval(double z, double confidence, double &low, double &high);
+	bool precise(double z, double relError, double confidence, double target);
+};
+
+#endif /* _RATIO_H_ */
@@ -0,0 +1,406 @@
+/**********************************
+ * FILE NAME: Scenario.cpp
+ *
+ * DESCRIPTION: Definition of the timed test scenario classes
+ **********************************/
+
+#include "Scenario.h"
+
+/**
+ * FUNCTION NAME: parse
+ *
+ * DESCRIPTION: Read "exp:<mean>" or "weibull:<shape>:<scale>", times in ticks
+ */
+int Lifetime::parse(const char *spec) {
+	if ( sscanf(spec, "exp:%lf", &scale) == 1 ) {
+		weibull = false;
+		shape = 1;
+	}
+	else if ( sscanf(spec, "weibull:%lf:%lf", &shape, &scale) == 2 ) {
+		weibull = true;
+	}
+	else {
+		return FAILURE;
+	}
+	return (shape > 0 && scale > 0) ? SUCCESS : FAILURE;
+}
+
+/**
+ * FUNCTION NAME: draw
+ *
+ * DESCRIPTION: Draw a number of ticks, at least 1, by inverting the distribution function
+ */
+int Lifetime::draw(unsigned int *seed) {
+	// Uniform in (0, 1), never 0 so that the log is finite
+	double u = (rand_r(seed) + 1.0) / (RAND_MAX + 2.0);
+	double ticks = weibull ? scale * pow(-log(u), 1 / shape) : -scale * log(u);
+	return (int)min(max(ticks + 0.5, 1.0), 1e9);
+}
+
+/**
+ * Constructor
+ */
+Scenario::Scenario(Params *par): par(par), nextseq(0) {
+	// A state of its own, apart from the nodes' and the senders', so the picks only depend on SEED;
+	// the default scenario's failed nodes differ from the ones rand() after srand(SEED) picked
+	randSeed = par->SEED + 31;
+
+	if ( par->scenario.empty() ) {
+		compileDefault();
+		return;
+	}
+	for ( unsigned int i = 0; i < par->scenario.size(); i++ ) {
+		const char *line = par->scenario[i].c_str();
+		char name[64];
+
+		if ( 0 == strncmp(line, "BRANCH", 6) ) {
+			if ( sscanf(line + 6, "%63s", name) != 1 ) {
+				sprintf(name, "%d", (int)branchNames.size());
+			}
+			branchNames.push_back(name);
+			branchLines.push_back(vector<string>());
+		}
+		else if ( !branchLines.empty() ) {
+			branchLines.back().push_back(line);
+		}
+		else if ( compileLine(line) == FAILURE ) {
+			fprintf(stderr, "Bad scenario line ignored: %s\n", line);
+		}
+	}
+
+	// A branch starts at the checkpoint, so the events it has before then all happen at it
+	for ( unsigned int k = 0; par->CHECKPOINT >= 0 && k < branchLines.size(); k++ ) {
+		for ( unsigned int i = 0; i < branchLines[k].size(); i++ ) {
+			int time;
+			const char *line = branchLines[k][i].c_str();
+			if ( sscanf(line, "%d", &time) == 1 && time < par->CHECKPOINT ) {
+				fprintf(stderr, "Branch %s line before CHECKPOINT %d happens at it: %s\n", branchNames[k].c_str(), par->CHECKPOINT, line);
+			}
+		}
+	}
+}
+
+/**
+ * Destructor
+ */
+Scenario::~Scenario() {}
+
+/**
+ * FUNCTION NAME: compileDefault
+ *
+ * DESCRIPTION: The MP1 scenario: a node joins every 1/STEP_RATE ticks, messages are dropped
+ * 				from t=50 to t=300 and one node, or half the group, fails at t=100
+ */
+void Scenario::compileDefault() {
+	ScenarioEvent ev;
+	int i, removed;
+
+	ev.type = EV_JOIN;
+	for ( i = 0; i < par->EN_GPSZ; i++ ) {
+		if ( !ev.nodes.empty() && ev.time != (int)(par->STEP_RATE*i) ) {
+			add(ev);
+			ev.nodes.clear();
+		}
+		ev.time = (int)(par->STEP_RATE*i);
+		ev.nodes.push_back(i);
+	}
+	add(ev);
+	ev.nodes.clear();
+
+	if ( par->DROP_MSG ) {
+		ev.type = EV_DROP;
+		ev.time = 50;
+		ev.value = par->MSG_DROP_PROB;
+		add(ev);
+		ev.time = 300;
+		ev.value = 0;
+		add(ev);
+	}
+
+	ev.type = EV_CRASH;
+	ev.time = 100;
+	if ( par->SINGLE_FAILURE ) {
+		ev.nodes.push_back(rand_r(&randSeed) % par->EN_GPSZ);
+	}
+	else {
+		removed = rand_r(&randSeed) % par->EN_GPSZ/2;
+		for ( i = removed; i < removed + par->EN_GPSZ/2; i++ ) {
+			ev.nodes.push_back(i);
+		}
+	}
+	add(ev);
+}
+
+/**
+ * FUNCTION NAME: compileLine
+ *
+ * DESCRIPTION: Compile one "<time> <EVENT> [args]" line into events
+ */
+int Scenario::compileLine(const char *line) {
+	char name[32], arg[256];
+	int step = 0;
+	unsigned int i;
+	ScenarioEvent ev;
+
+	arg[0] = 0;
+	if ( sscanf(line, "%d %31s %255s %d", &ev.time, name, arg, &step) < 2 || ev.time < 0 ) {
+		return FAILURE;
+	}
+
+	if ( 0 == strcmp(name, "CHURN") ) {
+		char session[64], downtime[64];
+		Churn churn;
+		if ( sscanf(line, "%*d %*s %*s %63s %63s %lf", session, downtime, &churn.rejoin) != 3
+				|| churn.session.parse(session) == FAILURE || churn.downtime.parse(downtime) == FAILURE
+				|| parseNodes(arg, ev.nodes) == FAILURE ) {
+			return FAILURE;
+		}
+		// The others join and rejoin through the introducer, so it never churns
+		ev.nodes.erase(remove(ev.nodes.begin(), ev.nodes.end(), 0), ev.nodes.end());
+		if ( ev.nodes.empty() ) {
+			return FAILURE;
+		}
+		ev.type = EV_CHURN;
+		ev.churn = churns.size();
+		churns.push_back(churn);
+		add(ev);
+		return SUCCESS;
+	}
+
+	if ( 0 == strcmp(name, "DROP") ) {
+		ev.type = EV_DROP;
+		ev.value = atof(arg);
+		add(ev);
+		return SUCCESS;
+	}
+	if ( 0 == strcmp(name, "HEAL") ) {
+		ev.type = EV_HEAL;
+		add(ev);
+		return SUCCESS;
+	}
+
+	if ( 0 == strcmp(name, "JOIN") ) ev.type = EV_JOIN;
+	else if ( 0 == strcmp(name, "CRASH") ) ev.type = EV_CRASH;
+	else if ( 0 == strcmp(name, "REJOIN") ) ev.type = EV_REJOIN;
+	else if ( 0 == strcmp(name, "LEAVE") ) ev.type = EV_LEAVE;
+	else if ( 0 == strcmp(name, "PARTITION") ) ev.type = EV_PARTITION;
+	else return FAILURE;
+
+	if ( parseNodes(arg, ev.nodes) == FAILURE ) {
+		return FAILURE;
+	}
+
+	// A join wave with a step becomes one event per node
+	if ( ev.type == EV_JOIN && step > 0 ) {
+		vector<int> nodes = ev.nodes;
+		int start = ev.time;
+		for ( i = 0; i < nodes.size(); i++ ) {
+			ev.time = start + i * step;
+			ev.nodes.assign(1, nodes[i]);
+			add(ev);
+		}
+		return SUCCESS;
+	}
+
+	add(ev);
+	return SUCCESS;
+}
+
+/**
+ * FUNCTION NAME: parseNodes
+ *
+ * DESCRIPTION: Parse a comma separated list of "i", "i-j", "all", "random:k" and "random:p%" node
+ * 				indices
+ */
+int Scenario::parseNodes(const char *spec, vector<int> &nodes) {
+	char item[64];
+	int first, last, count;
+	const char *curr = spec;
+
+	while ( *curr ) {
+		int len = strcspn(curr, ",");
+		if ( len == 0 || len >= (int)sizeof(item) ) {
+			return FAILURE;
+		}
+		memcpy(item, curr, len);
+		item[len] = 0;
+		curr += len + (curr[len] == ',' ? 1 : 0);
+
+		if ( 0 == strcmp(item, "all") ) {
+			for ( int i = 0; i < par->EN_GPSZ; i++ ) {
+				nodes.push_back(i);
+			}
+			continue;
+		}
+
+		if ( sscanf(item, "random:%d", &count) == 1 ) {
+			// p% of the group, at least one node
+			if ( item[len - 1] == '%' ) {
+				count = max(1, (int)((long)par->EN_GPSZ * count / 100));
+			}
+			// k distinct nodes from a partial shuffle
+			vector<int> pool(par->EN_GPSZ);
+			for ( int i = 0; i < par->EN_GPSZ; i++ ) {
+				pool[i] = i;
+			}
+			count = min(count, par->EN_GPSZ);
+			for ( int i = 0; i < count; i++ ) {
+				swap(pool[i], pool[i + rand_r(&randSeed) % (par->EN_GPSZ - i)]);
+				nodes.push_back(pool[i]);
+			}
+			continue;
+		}
+
+		int n = sscanf(item, "%d-%d", &first, &last);
+		if ( n < 1 ) {
+			return FAILURE;
+		}
+		if ( n == 1 ) {
+			last = first;
+		}
+		if ( first < 0 || last >= par->EN_GPSZ || first > last ) {
+			return FAILURE;
+		}
+		for ( int i = first; i <= last; i++ ) {
+			nodes.push_back(i);
+		}
+	}
+	return nodes.empty() ? FAILURE : SUCCESS;
+}
+
+/**
+ * FUNCTION NAME: add
+ *
+ * DESCRIPTION: Queue an event; events of the same tick keep the order they were added in
+ */
+void Scenario::add(ScenarioEvent ev) {
+	ev.seq = nextseq++;
+	events.push(ev);
+}
+
+/**
+ * FUNCTION NAME: nextDue
+ *
+ * DESCRIPTION: Pop the next event that is due at the given time, if any, and draw what follows
+ * 				a churn event. Costs a single comparison on ticks without events.
+ */
+bool Scenario::nextDue(int time, ScenarioEvent &ev) {
+	while ( !events.empty() && events.top().time <= time ) {
+		ev = events.top();
+		events.pop();
+		if ( ev.churn >= 0 ) {
+			churnNext(ev);
+		}
+		// A CHURN line only starts its nodes' sessions
+		if ( ev.type != EV_CHURN ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * FUNCTION NAME: addChurn
+ *
+ * DESCRIPTION: Queue a crash or restart of one churning node, unless it is past the end of the run
+ */
+void Scenario::addChurn(enum EventTypes type, int node, int time, int churn) {
+	ScenarioEvent ev;
+
+	if ( time >= par->TOTAL_TIME ) {
+		return;
+	}
+	ev.time = time;
+	ev.type = type;
+	ev.nodes.assign(1, node);
+	ev.churn = churn;
+	add(ev);
+}
+
+/**
+ * FUNCTION NAME: churnNext
+ *
+ * DESCRIPTION: Draw the event that follows a churn event: the end of the first session of every
+ * 				node of a CHURN line, the restart after a crash, if the node comes back, and the
+ * 				end of the next session after a restart
+ */
+void Scenario::churnNext(ScenarioEvent &ev) {
+	Churn &churn = churns[ev.churn];
+	unsigned int i;
+
+	switch ( ev.type ) {
+	case EV_CHURN:
+		for ( i = 0; i < ev.nodes.size(); i++ ) {
+			addChurn(EV_CRASH, ev.nodes[i], ev.time + churn.session.draw(&randSeed), ev.churn);
+		}
+		break;
+	case EV_CRASH:
+		if ( (rand_r(&randSeed) + 0.5) / (RAND_MAX + 1.0) < churn.rejoin ) {
+			addChurn(EV_REJOIN, ev.nodes[0], ev.time + churn.downtime.draw(&randSeed), ev.churn);
+		}
+		break;
+	case EV_REJOIN:
+		addChurn(EV_CRASH, ev.nodes[0], ev.time + churn.session.draw(&randSeed), ev.churn);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * FUNCTION NAME: branches
+ *
+ * DESCRIPTION: Number of what-if branches
+ */
+int Scenario::branches() {
+	return branchNames.size();
+}
+
+/**
+ * FUNCTION NAME: branchName
+ *
+ * DESCRIPTION: Name of the kth branch
+ */
+string Scenario::branchName(int k) {
+	return branchNames[k];
+}
+
+/**
+ * FUNCTION NAME: firstBranchTime
+ *
+ * DESCRIPTION: Earliest time of any branch event, the latest tick the branches can share
+ */
+int Scenario::firstBranchTime() {
+	int first = -1, time;
+
+	for ( unsigned int k = 0; k < branchLines.size(); k++ ) {
+		for ( unsigned int i = 0; i < branchLines[k].size(); i++ ) {
+			if ( sscanf(branchLines[k][i].c_str(), "%d", &time) == 1 && (first < 0 || time < first) ) {
+				first = time;
+			}
+		}
+	}
+	return first;
+}
+
+/**
+ * FUNCTION NAME: enterBranch
+ *
+ * DESCRIPTION: Compile the events of the kth branch into the queue
+ */
+void Scenario::enterBranch(int k) {
+	for ( unsigned int i = 0; i < branchLines[k].size(); i++ ) {
+		if ( compileLine(branchLines[k][i].c_str()) == FAILURE ) {
+			fprintf(stderr, "Bad scenario line ignored: %s\n", branchLines[k][i].c_str());
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: empty
+ *
+ * DESCRIPTION: True when no events are left
+ */
+bool Scenario::empty() {
+	return events.empty();
+}
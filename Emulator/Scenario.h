@@ -0,0 +1,143 @@
+/**********************************
+ * FILE NAME: Scenario.h
+ *
+ * DESCRIPTION: Header file of the timed test scenario classes
+ **********************************/
+
+#ifndef _SCENARIO_H_
+#define _SCENARIO_H_
+
+#include "stdincludes.h"
+#include "Params.h"
+
+/**
+ * Event Types
+ */
+enum EventTypes {
+	EV_JOIN,
+	EV_CRASH,
+	EV_REJOIN,
+	EV_LEAVE,
+	EV_DROP,
+	EV_PARTITION,
+	EV_HEAL,
+	EV_CHURN,
+};
+
+/**
+ * CLASS NAME: ScenarioEvent
+ *
+ * DESCRIPTION: One timed event of a scenario, with the node indices it applies to
+ */
+class ScenarioEvent {
+public:
+	int time;
+	// position in the scenario, keeps events of the same tick in file order
+	int seq;
+	enum EventTypes type;
+	vector<int> nodes;
+	double value;
+	// CHURN line the event was drawn for, -1 if none
+	int churn;
+	ScenarioEvent(): time(0), seq(0), type(EV_JOIN), value(0), churn(-1) {}
+};
+
+/**
+ * CLASS NAME: Lifetime
+ *
+ * DESCRIPTION: Distribution of the ticks a node stays up or down, "exp:<mean>" or
+ * 				"weibull:<shape>:<scale>". Weibull shapes below 1 give many short sessions and a few
+ * 				very long ones.
+ */
+class Lifetime {
+public:
+	bool weibull;
+	double shape;
+	double scale;
+	Lifetime(): weibull(false), shape(1), scale(1) {}
+	int parse(const char *spec);
+	int draw(unsigned int *seed);
+};
+
+/**
+ * CLASS NAME: Churn
+ *
+ * DESCRIPTION: The settings of one CHURN line: how long its nodes stay up, how long they stay
+ * 				down after a crash and the probability that they come back at all
+ */
+class Churn {
+public:
+	Lifetime session;
+	Lifetime downtime;
+	double rejoin;
+	Churn(): rejoin(1) {}
+};
+
+/**
+ * CLASS NAME: LaterEvent
+ *
+ * DESCRIPTION: Orders the event queue so that the earliest event is on top
+ */
+class LaterEvent {
+public:
+	bool operator ()(const ScenarioEvent &a, const ScenarioEvent &b) const {
+		return a.time != b.time ? a.time > b.time : a.seq > b.seq;
+	}
+};
+
+/**
+ * CLASS NAME: Scenario
+ *
+ * DESCRIPTION: The SCENARIO section of a test case compiled into a time sorted event queue.
+ * 				Without a SCENARIO section the classic MP1 scenario is built from the
+ * 				SINGLE_FAILURE/DROP_MSG settings. Random node picks are resolved once here.
+ *
+ * 				Lines have the form "<time> <EVENT> [args]", nodes are indices into the group
+ * 				given as a comma separated list of "i", "i-j" or "random:k":
+ * 				  JOIN <nodes> [step]   introduce the nodes, one every step ticks
+ * 				  CRASH <nodes>         fail the nodes silently
+ * 				  REJOIN <nodes>        restart failed nodes with a fresh state
+ * 				  LEAVE <nodes>         take the nodes out of the group
+ * 				  DROP <prob>           drop messages with this probability, 0 stops dropping
+ * 				  PARTITION <nodes>     cut the nodes off from everybody else
+ * 				  HEAL                  remove all partitions
+ * 				  CHURN <nodes> <session> <downtime> <rejoin>
+ * 				                        crash every node after a session drawn from <session>,
+ * 				                        restart it after a <downtime> with probability <rejoin>
+ * 				                        and start over
+ *
+ * 				Churn is drawn lazily: the queue holds one event per churning node, the next one
+ * 				being drawn when it is popped, and nothing at or after TOTAL_TIME.
+ *
+ * 				A "BRANCH <name>" line starts a what-if branch: the lines up to the next BRANCH
+ * 				are only compiled by enterBranch() in the process forked for that branch.
+ */
+class Scenario {
+private:
+	Params *par;
+	priority_queue<ScenarioEvent, vector<ScenarioEvent>, LaterEvent> events;
+	int nextseq;
+	unsigned int randSeed;
+	// Settings of the CHURN lines, indexed by ScenarioEvent::churn
+	vector<Churn> churns;
+	// Names and lines of the what-if branches
+	vector<string> branchNames;
+	vector< vector<string> > branchLines;
+	void compileDefault();
+	int compileLine(const char *line);
+	int parseNodes(const char *spec, vector<int> &nodes);
+	void addChurn(enum EventTypes type, int node, int time, int churn);
+	void churnNext(ScenarioEvent &ev);
+public:
+	Scenario(Params *par);
+	virtual ~Scenario();
+	void add(ScenarioEvent ev);
+	bool nextDue(int time, ScenarioEvent &ev);
+	bool empty();
+	int branches();
+	string branchName(int k);
+	int firstBranchTime();
+	void enterBranch(int k);
+};
+
+#endif /* _SCENARIO_H_ */
@@ -0,0 +1,343 @@
+/**********************************
+ * FILE NAME: Shard.cpp
+ *
+ * DESCRIPTION: Definition of the shared memory link between the processes of a sharded run
+ **********************************/
+
+#include "Shard.h"
+
+/**
+ * Constructor
+ * Maps one anonymous shared region; it has to be called before the workers are forked
+ */
+ShardLink::ShardLink(Params *par, int nshards): par(par), nshards(nshards), me(-1), warned(false) {
+	size_t barrierBytes = (sizeof(pthread_barrier_t) + 63) / 64 * 64;
+	size_t totalsBytes = 2 * nshards * sizeof(unsigned long);
+	size_t memoryBytes = nshards * (MEM_TAGS + 2) * sizeof(long);
+	size_t viewBytes = nshards * (sizeof(int) + (size_t)SHARD_VIEW_CHANGES * sizeof(ShardView));
+	size_t eventBytesTotal = sizeof(int) + SHARD_EVENT_BYTES;
+	size_t queueBytes = (size_t)nshards * nshards * (sizeof(size_t) + (size_t)SHARD_QUEUE_BYTES);
+
+	regionSize = barrierBytes + totalsBytes + memoryBytes + viewBytes + eventBytesTotal + queueBytes;
+	region = (char *)mmap(NULL, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if ( region == MAP_FAILED ) {
+		perror("mmap");
+		exit(FAILURE);
+	}
+
+	char *curr = region;
+	barrier = (pthread_barrier_t *)curr;
+	curr += barrierBytes;
+	totals = (unsigned long *)curr;
+	curr += totalsBytes;
+	memoryPeaks = (long *)curr;
+	curr += memoryBytes;
+	viewCount = (int *)curr;
+	curr += nshards * sizeof(int);
+	viewArea = (ShardView *)curr;
+	curr += (size_t)nshards * SHARD_VIEW_CHANGES * sizeof(ShardView);
+	eventBytes = (int *)curr;
+	curr += sizeof(int);
+	eventArea = curr;
+	curr += SHARD_EVENT_BYTES;
+	queueUsed = (size_t *)curr;
+	curr += (size_t)nshards * nshards * sizeof(size_t);
+	queueArea = curr;
+
+	// The shards and the controller
+	pthread_barrierattr_t attr;
+	pthread_barrierattr_init(&attr);
+	pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+	pthread_barrier_init(barrier, &attr, nshards + 1);
+	pthread_barrierattr_destroy(&attr);
+}
+
+/**
+ * Destructor
+ */
+ShardLink::~ShardLink() {
+	if ( me < 0 ) {
+		pthread_barrier_destroy(barrier);
+	}
+	munmap(region, regionSize);
+}
+
+/**
+ * FUNCTION NAME: shards
+ *
+ * DESCRIPTION: Number of shards
+ */
+int ShardLink::shards() {
+	return nshards;
+}
+
+/**
+ * FUNCTION NAME: self
+ *
+ * DESCRIPTION: Shard of this process, -1 in the controller
+ */
+int ShardLink::self() {
+	return me;
+}
+
+/**
+ * FUNCTION NAME: attach
+ *
+ * DESCRIPTION: Called in a forked worker, which from now on is the given shard
+ */
+void ShardLink::attach(int shard) {
+	me = shard;
+}
+
+/**
+ * FUNCTION NAME: first
+ *
+ * DESCRIPTION: First node index of a shard
+ */
+int ShardLink::first(int shard) {
+	return (int)((long)par->EN_GPSZ * shard / nshards);
+}
+
+/**
+ * FUNCTION NAME: last
+ *
+ * DESCRIPTION: One past the last node index of a shard
+ */
+int ShardLink::last(int shard) {
+	return first(shard + 1);
+}
+
+/**
+ * FUNCTION NAME: shardOf
+ *
+ * DESCRIPTION: Shard that owns the node with the given id, -1 if there is no such node
+ */
+int ShardLink::shardOf(int id) {
+	if ( id < 1 || id > par->EN_GPSZ ) {
+		return -1;
+	}
+	int shard = (int)((long)(id - 1) * nshards / par->EN_GPSZ);
+	// Rounding in first() can put the boundary one node either way
+	while ( shard > 0 && id - 1 < first(shard) ) {
+		shard--;
+	}
+	while ( shard < nshards - 1 && id - 1 >= last(shard) ) {
+		shard++;
+	}
+	return shard;
+}
+
+/**
+ * FUNCTION NAME: wait
+ *
+ * DESCRIPTION: Wait until all shards and the controller got here
+ */
+void ShardLink::wait() {
+	pthread_barrier_wait(barrier);
+}
+
+/**
+ * FUNCTION NAME: publish
+ *
+ * DESCRIPTION: Controller: hand out the scenario events of this tick, before the first barrier
+ */
+void ShardLink::publish(vector<ScenarioEvent> &events) {
+	char *curr = eventArea;
+	char *end = eventArea + SHARD_EVENT_BYTES;
+
+	for ( unsigned int k = 0; k < events.size(); k++ ) {
+		ScenarioEvent &ev = events[k];
+		int count = ev.nodes.size();
+		size_t bytes = 2 * sizeof(int) + sizeof(double) + sizeof(int) + count * sizeof(int);
+		if ( curr + bytes > end ) {
+			fprintf(stderr, "Too many scenario events at time=%d, the rest is ignored\n", ev.time);
+			break;
+		}
+		memcpy(curr, &ev.time, sizeof(int));
+		memcpy(curr + sizeof(int), &ev.type, sizeof(int));
+		memcpy(curr + 2 * sizeof(int), &ev.value, sizeof(double));
+		memcpy(curr + 2 * sizeof(int) + sizeof(double), &count, sizeof(int));
+		memcpy(curr + 3 * sizeof(int) + sizeof(double), ev.nodes.data(), count * sizeof(int));
+		curr += bytes;
+	}
+	*eventBytes = curr - eventArea;
+}
+
+/**
+ * FUNCTION NAME: receive
+ *
+ * DESCRIPTION: Shard: read the scenario events of this tick, after the first barrier
+ */
+void ShardLink::receive(vector<ScenarioEvent> &events) {
+	char *curr = eventArea;
+	char *end = eventArea + *eventBytes;
+	int type, count;
+
+	events.clear();
+	while ( curr < end ) {
+		ScenarioEvent ev;
+		memcpy(&ev.time, curr, sizeof(int));
+		memcpy(&type, curr + sizeof(int), sizeof(int));
+		memcpy(&ev.value, curr + 2 * sizeof(int), sizeof(double));
+		memcpy(&count, curr + 2 * sizeof(int) + sizeof(double), sizeof(int));
+		ev.type = (enum EventTypes)type;
+		ev.nodes.resize(count);
+		memcpy(ev.nodes.data(), curr + 3 * sizeof(int) + sizeof(double), count * sizeof(int));
+		curr += 3 * sizeof(int) + sizeof(double) + count * sizeof(int);
+		events.push_back(ev);
+	}
+}
+
+/**
+ * FUNCTION NAME: queue
+ *
+ * DESCRIPTION: Start of the message queue from one shard to another
+ */
+char *ShardLink::queue(int from, int to) {
+	return queueArea + ((size_t)from * nshards + to) * (size_t)SHARD_QUEUE_BYTES;
+}
+
+/**
+ * FUNCTION NAME: clearQueues
+ *
+ * DESCRIPTION: Shard: empty its outgoing queues at the start of a tick
+ */
+void ShardLink::clearQueues() {
+	for ( int to = 0; to < nshards; to++ ) {
+		queueUsed[me * nshards + to] = 0;
+	}
+	viewCount[me] = 0;
+}
+
+/**
+ * FUNCTION NAME: put
+ *
+ * DESCRIPTION: Shard: copy a message into its queue to another shard
+ *
+ * RETURNS:
+ * false if the queue is full and the message is lost
+ */
+bool ShardLink::put(int to, void *msg, int bytes) {
+	size_t &used = queueUsed[me * nshards + to];
+	// Entries are padded to 8 bytes so that every message header stays aligned
+	size_t step = (sizeof(int) + bytes + 7) / 8 * 8;
+	if ( used + step > SHARD_QUEUE_BYTES ) {
+		return false;
+	}
+	char *curr = queue(me, to) + used;
+	memcpy(curr, &bytes, sizeof(int));
+	memcpy(curr + sizeof(int), msg, bytes);
+	used += step;
+	return true;
+}
+
+/**
+ * FUNCTION NAME: next
+ *
+ * DESCRIPTION: Shard: the message at pos in the queue from another shard to this one, and move
+ * 				pos past it
+ *
+ * RETURNS:
+ * the message, NULL at the end of the queue
+ */
+char *ShardLink::next(int from, size_t &pos, int &bytes) {
+	if ( pos >= queueUsed[from * nshards + me] ) {
+		return NULL;
+	}
+	char *curr = queue(from, me) + pos;
+	memcpy(&bytes, curr, sizeof(int));
+	pos += (sizeof(int) + bytes + 7) / 8 * 8;
+	return curr + sizeof(int);
+}
+
+/**
+ * FUNCTION NAME: report
+ *
+ * DESCRIPTION: Shard: pass one view change of one of its nodes on to the controller
+ */
+void ShardLink::report(int observer, int subject, int time, bool added) {
+	if ( viewCount[me] >= SHARD_VIEW_CHANGES ) {
+		if ( !warned ) {
+			fprintf(stderr, "Shard %d: more than %d view changes in a tick, the oracle misses some\n", me, SHARD_VIEW_CHANGES);
+			warned = true;
+		}
+		return;
+	}
+	ShardView &v = viewArea[(size_t)me * SHARD_VIEW_CHANGES + viewCount[me]++];
+	v.observer = observer;
+	v.subject = subject;
+	v.time = time;
+	v.added = added;
+}
+
+/**
+ * FUNCTION NAME: views
+ *
+ * DESCRIPTION: Controller: number of view changes a shard reported this tick
+ */
+int ShardLink::views(int shard) {
+	return viewCount[shard];
+}
+
+/**
+ * FUNCTION NAME: view
+ *
+ * DESCRIPTION: Controller: the kth view change a shard reported this tick
+ */
+ShardView &ShardLink::view(int shard, int k) {
+	return viewArea[(size_t)shard * SHARD_VIEW_CHANGES + k];
+}
+
+/**
+ * FUNCTION NAME: setTotals
+ *
+ * DESCRIPTION: Shard: leave the message totals of its nodes so far for the controller
+ */
+void ShardLink::setTotals(unsigned long msgs, unsigned long bytes) {
+	totals[2 * me] = msgs;
+	totals[2 * me + 1] = bytes;
+}
+
+/**
+ * FUNCTION NAME: sentTotal
+ *
+ * DESCRIPTION: Controller: messages sent by all shards
+ */
+unsigned long ShardLink::sentTotal() {
+	unsigned long total = 0;
+	for ( int k = 0; k < nshards; k++ ) {
+		total += totals[2 * k];
+	}
+	return total;
+}
+
+/**
+ * FUNCTION NAME: sentBytes
+ *
+ * DESCRIPTION: Controller: message bytes sent by all shards
+ */
+unsigned long ShardLink::sentBytes() {
+	unsigned long total = 0;
+	for ( int k = 0; k < nshards; k++ ) {
+		total += totals[2 * k + 1];
+	}
+	return total;
+}
+
+/**
+ * FUNCTION NAME: setMemory
+ *
+ * DESCRIPTION: Shard: leave one of its memory peaks for the controller
+ */
+void ShardLink::setMemory(int slot, long bytes) {
+	memoryPeaks[me * (MEM_TAGS + 2) + slot] = bytes;
+}
+
+/**
+ * FUNCTION NAME: memory
+ *
+ * DESCRIPTION: Controller: one of the memory peaks of a shard
+ */
+long ShardLink::memory(int shard, int slot) {
+	return memoryPeaks[shard * (MEM_TAGS + 2) + slot];
+}
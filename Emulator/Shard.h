@@ -0,0 +1,101 @@
+/**********************************
+ * FILE NAME: Shard.h
+ *
+ * DESCRIPTION: Header file of the shared memory link between the processes of a sharded run
+ **********************************/
+
+#ifndef _SHARD_H_
+#define _SHARD_H_
+
+#include "stdincludes.h"
+#include "Params.h"
+#include "Scenario.h"
+#include "Memory.h"
+#include <pthread.h>
+#include <sys/mman.h>
+
+/*
+ * Macros
+ */
+// bytes of the one way message queue from one shard to another, per tick
+#define SHARD_QUEUE_BYTES (8 << 20)
+// view changes one shard can report to the controller per tick
+#define SHARD_VIEW_CHANGES (1 << 18)
+// bytes of the scenario events the controller hands out per tick
+#define SHARD_EVENT_BYTES (1 << 20)
+
+/**
+ * CLASS NAME: ShardView
+ *
+ * DESCRIPTION: One view change a shard reports to the controller, indices are node ids
+ */
+class ShardView {
+public:
+	int observer;
+	int subject;
+	int time;
+	int added;
+};
+
+/**
+ * CLASS NAME: ShardLink
+ *
+ * DESCRIPTION: Shared memory set up before the worker processes of a sharded run are forked.
+ * 				Shard k owns a contiguous range of node indices. Per tick the controller hands
+ * 				the due scenario events to the shards, every shard fills one queue per other
+ * 				shard with the messages its nodes sent there and reports the view changes of
+ * 				its nodes, and all processes meet at a process shared barrier twice:
+ *
+ * 				  controller: publish events  | wait | bookkeeping          | wait | read views
+ * 				  shard:                      | wait | step, fill queues    | wait | drain queues
+ *
+ * 				A queue is only written between the first and the second barrier of a tick and
+ * 				only read between the second barrier and the first one of the next tick.
+ */
+class ShardLink {
+private:
+	Params *par;
+	int nshards;
+	// Shard of this process, -1 in the controller
+	int me;
+	// Told the user the view changes of a tick overflowed
+	bool warned;
+	char *region;
+	size_t regionSize;
+	pthread_barrier_t *barrier;
+	unsigned long *totals;
+	// Per shard: peak bytes of every subsystem, of all of them and of the largest node
+	long *memoryPeaks;
+	int *viewCount;
+	ShardView *viewArea;
+	int *eventBytes;
+	char *eventArea;
+	size_t *queueUsed;
+	char *queueArea;
+	char *queue(int from, int to);
+public:
+	ShardLink(Params *par, int nshards);
+	virtual ~ShardLink();
+	int shards();
+	int self();
+	void attach(int shard);
+	int first(int shard);
+	int last(int shard);
+	int shardOf(int id);
+	void wait();
+	void publish(vector<ScenarioEvent> &events);
+	void receive(vector<ScenarioEvent> &events);
+	void clearQueues();
+	bool put(int to, void *msg, int bytes);
+	char *next(int from, size_t &pos, int &bytes);
+	void report(int observer, int subject, int time, bool added);
+	int views(int shard);
+	ShardView &view(int shard, int k);
+	void setTotals(unsigned long msgs, unsigned long bytes);
+	unsigned long sentTotal();
+	unsigned long sentBytes();
+	void setMemory(int slot, long bytes);
+	long memory(int shard, int slot);
+};
+
+#endif /* _SHARD_H_ */
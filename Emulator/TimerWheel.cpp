@@ -0,0 +1,209 @@
+/**********************************
+ * FILE NAME: TimerWheel.cpp
+ *
+ * DESCRIPTION: Definition of the hierarchical timing wheel protocols keep their timeouts in
+ **********************************/
+
+#include "TimerWheel.h"
+
+/**
+ * Constructor
+ */
+TimerWheel::TimerWheel(): current(-1) {}
+
+/**
+ * FUNCTION NAME: key
+ *
+ * DESCRIPTION: Key of the timer of a member
+ */
+long TimerWheel::key(int id, short port) {
+	return ((long)id << 16) | (unsigned short)port;
+}
+
+/**
+ * FUNCTION NAME: reset
+ *
+ * DESCRIPTION: Drop all timers, the next expire() starts at tick now
+ */
+void TimerWheel::reset(int now) {
+	timers.clear();
+	heads.clear();
+	spare.clear();
+	index.clear();
+	current = now - 1;
+}
+
+/**
+ * FUNCTION NAME: link
+ *
+ * DESCRIPTION: Put a timer in the list its tick belongs to, seen from tick base, the next one
+ * 				expire() handles
+ */
+void TimerWheel::link(int t, int base) {
+	Timer &timer = timers[t];
+	int list = READY;
+
+	if ( timer.due >= base ) {
+		long delta = timer.due - base;
+		list = FAR;
+		for ( int level = 0; level < WHEEL_LEVELS; level++ ) {
+			if ( delta < (1L << ((level + 1) * WHEEL_BITS)) ) {
+				list = level * WHEEL_SLOTS + ((timer.due >> (level * WHEEL_BITS)) & (WHEEL_SLOTS - 1));
+				break;
+			}
+		}
+	}
+	if ( heads.empty() ) {
+		heads.assign(LISTS, -1);
+	}
+	timer.list = list;
+	timer.prev = -1;
+	timer.next = heads[list];
+	if ( timer.next >= 0 ) {
+		timers[timer.next].prev = t;
+	}
+	heads[list] = t;
+}
+
+/**
+ * FUNCTION NAME: unlink
+ *
+ * DESCRIPTION: Take a timer out of its list
+ */
+void TimerWheel::unlink(int t) {
+	Timer &timer = timers[t];
+
+	if ( timer.prev >= 0 ) {
+		timers[timer.prev].next = timer.next;
+	}
+	else {
+		heads[timer.list] = timer.next;
+	}
+	if ( timer.next >= 0 ) {
+		timers[timer.next].prev = timer.prev;
+	}
+}
+
+/**
+ * FUNCTION NAME: cascade
+ *
+ * DESCRIPTION: Move the timers of a list to the lower levels, seen from tick base
+ */
+void TimerWheel::cascade(int list, int base) {
+	int t = heads[list];
+
+	heads[list] = -1;
+	while ( t >= 0 ) {
+		int next = timers[t].next;
+		link(t, base);
+		t = next;
+	}
+}
+
+/**
+ * FUNCTION NAME: schedule
+ *
+ * DESCRIPTION: Make the timer of key due at a tick, creating it or moving it. A tick expire()
+ * 				already handled makes it fire at the next expire().
+ */
+void TimerWheel::schedule(long key, int due) {
+	auto it = index.find(key);
+	int t;
+
+	if ( it != index.end() ) {
+		t = it->second;
+		unlink(t);
+	}
+	else {
+		if ( !spare.empty() ) {
+			t = spare.back();
+			spare.pop_back();
+		}
+		else {
+			t = timers.size();
+			timers.push_back(Timer());
+		}
+		timers[t].key = key;
+		index[key] = t;
+	}
+	timers[t].due = due;
+	link(t, current + 1);
+}
+
+/**
+ * FUNCTION NAME: cancel
+ *
+ * DESCRIPTION: Drop the timer of key, if any
+ */
+void TimerWheel::cancel(long key) {
+	auto it = index.find(key);
+
+	if ( it == index.end() ) {
+		return;
+	}
+	unlink(it->second);
+	spare.push_back(it->second);
+	index.erase(it);
+}
+
+/**
+ * FUNCTION NAME: due
+ *
+ * DESCRIPTION: Tick the timer of key is due at, -1 if there is none
+ */
+int TimerWheel::due(long key) {
+	auto it = index.find(key);
+
+	return it == index.end() ? -1 : timers[it->second].due;
+}
+
+/**
+ * FUNCTION NAME: size
+ *
+ * DESCRIPTION: Number of timers
+ */
+int TimerWheel::size() {
+	return index.size();
+}
+
+/**
+ * FUNCTION NAME: bytesUsed
+ *
+ * DESCRIPTION: Bytes held by the timers, the lists and the index of the keys
+ */
+long TimerWheel::bytesUsed() {
+	return timers.capacity() * sizeof(Timer) + (heads.capacity() + spare.capacity()) * sizeof(int)
+			+ index.bucket_count() * sizeof(void *) + index.size() * (sizeof(pair<const long, int>) + 2 * sizeof(void *));
+}
+
+/**
+ * FUNCTION NAME: expire
+ *
+ * DESCRIPTION: Turn the wheel to tick now and hand out the keys of the timers that fired, which
+ * 				are dropped. Timers due at the same tick fire in no particular order.
+ */
+void TimerWheel::expire(int now, vector<long> &fired) {
+	fired.clear();
+
+	for ( int tick = current; tick <= now && !index.empty(); tick++ ) {
+		int list = READY;
+		if ( tick > current ) {
+			// Timers of a higher level slot that starts at this tick move down
+			for ( int level = WHEEL_LEVELS; level >= 1; level-- ) {
+				if ( (tick & ((1L << (level * WHEEL_BITS)) - 1)) != 0 ) {
+					continue;
+				}
+				cascade(level == WHEEL_LEVELS ? FAR : level * WHEEL_SLOTS + ((tick >> (level * WHEEL_BITS)) & (WHEEL_SLOTS - 1)), tick);
+			}
+			list = tick & (WHEEL_SLOTS - 1);
+		}
+		while ( heads[list] >= 0 ) {
+			int t = heads[list];
+			unlink(t);
+			fired.push_back(timers[t].key);
+			index.erase(timers[t].key);
+			spare.push_back(t);
+		}
+	}
+	current = max(current, now);
+}
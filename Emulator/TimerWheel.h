@@ -0,0 +1,70 @@
+/**********************************
+ * FILE NAME: TimerWheel.h
+ *
+ * DESCRIPTION: Header file of the hierarchical timing wheel protocols keep their timeouts in
+ **********************************/
+
+#ifndef _TIMERWHEEL_H_
+#define _TIMERWHEEL_H_
+
+#include "stdincludes.h"
+#include "Memory.h"
+#include <unordered_map>
+
+/*
+ * Macros
+ */
+// slots per level are 1 << WHEEL_BITS, a slot of level L spans 1 << (L * WHEEL_BITS) ticks
+#define WHEEL_BITS 4
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_LEVELS 4
+
+/**
+ * CLASS NAME: TimerWheel
+ *
+ * DESCRIPTION: One timer per key, each due at a tick. A timer is kept in the slot of the
+ * 				lowest level whose span reaches its tick and moves down a level each time the
+ * 				wheel turns past that slot, so expire() only touches the timers that fire and,
+ * 				once every WHEEL_SLOTS ticks and so on, the few that move down. Scheduling,
+ * 				rescheduling and cancelling a timer take constant time.
+ */
+class TimerWheel {
+private:
+	class Timer {
+	public:
+		long key;
+		int due;
+		// List the timer is in and its neighbours there, -1 at either end
+		int list;
+		int prev;
+		int next;
+	};
+	// Lists of level L are L * WHEEL_SLOTS + slot, then the timers that are due already and the
+	// ones beyond the top level
+	enum Lists {
+		READY = WHEEL_LEVELS * WHEEL_SLOTS,
+		FAR,
+		LISTS
+	};
+	vector<Timer, Counted<Timer, MEM_TIMERS> > timers;
+	vector<int, Counted<int, MEM_TIMERS> > heads;
+	vector<int, Counted<int, MEM_TIMERS> > spare;
+	unordered_map<long, int, hash<long>, equal_to<long>, Counted<pair<const long, int>, MEM_TIMERS> > index;
+	// Last tick expire() handled
+	int current;
+	void link(int t, int base);
+	void unlink(int t);
+	void cascade(int list, int base);
+public:
+	TimerWheel();
+	static long key(int id, short port);
+	void reset(int now);
+	void schedule(long key, int due);
+	void cancel(long key);
+	int due(long key);
+	int size();
+	long bytesUsed();
+	void expire(int now, vector<long> &fired);
+};
+
+#endif /* _TIMERWHEEL_H_ */
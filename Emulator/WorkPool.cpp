@@ -0,0 +1,152 @@
+/**********************************
+ * FILE NAME: WorkPool.cpp
+ *
+ * DESCRIPTION: Definition of the work stealing thread pool
+ **********************************/
+
+#include "WorkPool.h"
+
+/**
+ * Constructor
+ * The calling thread acts as worker 0, so only nthreads - 1 threads are spawned
+ */
+WorkPool::WorkPool(int nthreads, function<void()> init): nthreads(max(1, nthreads)), init(init), generation(0), busy(0), stopping(false) {
+	for ( int i = 0; i < this->nthreads; i++ ) {
+		workers.push_back(new Worker());
+	}
+	for ( int i = 1; i < this->nthreads; i++ ) {
+		threads.push_back(thread(&WorkPool::workerMain, this, i));
+	}
+}
+
+/**
+ * Destructor
+ */
+WorkPool::~WorkPool() {
+	{
+		unique_lock<mutex> lk(poolLock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for ( unsigned int i = 0; i < threads.size(); i++ ) {
+		threads[i].join();
+	}
+	for ( unsigned int i = 0; i < workers.size(); i++ ) {
+		delete workers[i];
+	}
+}
+
+/**
+ * FUNCTION NAME: size
+ *
+ * DESCRIPTION: Number of workers, including the calling thread
+ */
+int WorkPool::size() {
+	return nthreads;
+}
+
+/**
+ * FUNCTION NAME: run
+ *
+ * DESCRIPTION: Call fn(i) for every i in [0, n) across the pool and wait for all of them
+ */
+void WorkPool::run(int n, function<void(int)> fn) {
+	int i, w;
+	int chunk = max(1, n / (nthreads * CHUNKS_PER_WORKER));
+	int nchunks = (n + chunk - 1) / chunk;
+
+	if ( n <= 0 ) {
+		return;
+	}
+
+	// Deal each worker a contiguous block of chunks
+	for ( i = 0; i < nchunks; i++ ) {
+		w = (int)((long)i * nthreads / nchunks);
+		workers[w]->chunks.push_back(make_pair(i * chunk, min(n, (i + 1) * chunk)));
+	}
+
+	{
+		unique_lock<mutex> lk(poolLock);
+		job = fn;
+		busy = nthreads - 1;
+		generation++;
+	}
+	wake.notify_all();
+
+	runShare(0);
+
+	unique_lock<mutex> lk(poolLock);
+	done.wait(lk, [this] { return busy == 0; });
+}
+
+/**
+ * FUNCTION NAME: workerMain
+ *
+ * DESCRIPTION: Body of every spawned worker thread
+ */
+void WorkPool::workerMain(int id) {
+	int seen = 0;
+
+	if ( init ) {
+		init();
+	}
+
+	while ( true ) {
+		{
+			unique_lock<mutex> lk(poolLock);
+			wake.wait(lk, [this, seen] { return stopping || generation != seen; });
+			if ( stopping ) {
+				return;
+			}
+			seen = generation;
+		}
+
+		runShare(id);
+
+		{
+			unique_lock<mutex> lk(poolLock);
+			busy--;
+		}
+		done.notify_one();
+	}
+}
+
+/**
+ * FUNCTION NAME: runShare
+ *
+ * DESCRIPTION: Keep running chunks until none are left anywhere in the pool
+ */
+void WorkPool::runShare(int id) {
+	pair<int, int> chunk;
+
+	while ( take(id, chunk) ) {
+		for ( int i = chunk.first; i < chunk.second; i++ ) {
+			job(i);
+		}
+	}
+}
+
+/**
+ * FUNCTION NAME: take
+ *
+ * DESCRIPTION: Pop the next chunk of the own deque, or steal the last chunk of another worker
+ */
+bool WorkPool::take(int id, pair<int, int> &chunk) {
+	for ( int k = 0; k < nthreads; k++ ) {
+		Worker *victim = workers[(id + k) % nthreads];
+		lock_guard<mutex> lk(victim->lock);
+		if ( victim->chunks.empty() ) {
+			continue;
+		}
+		if ( k == 0 ) {
+			chunk = victim->chunks.front();
+			victim->chunks.pop_front();
+		}
+		else {
+			chunk = victim->chunks.back();
+			victim->chunks.pop_back();
+		}
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,60 @@
+/**********************************
+ * FILE NAME: WorkPool.h
+ *
+ * DESCRIPTION: Header file of the work stealing thread pool
+ **********************************/
+
+#ifndef _WORKPOOL_H_
+#define _WORKPOOL_H_
+
+#include "stdincludes.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+
+/*
+ * Macros
+ */
+// number of chunks each worker is dealt per job, so that idle workers have something to steal
+#define CHUNKS_PER_WORKER 8
+
+/**
+ * CLASS NAME: WorkPool
+ *
+ * DESCRIPTION: Fixed set of worker threads that run one job over an index range at a time.
+ * 				Every worker is dealt a contiguous block of chunks and steals chunks from the
+ * 				back of the other workers' deques once its own runs dry. run() only returns
+ * 				when the whole range has been processed, so it doubles as a barrier. Every
+ * 				spawned worker calls init, if given, before its first job.
+ */
+class WorkPool {
+private:
+	class Worker {
+	public:
+		mutex lock;
+		deque< pair<int, int> > chunks;
+	};
+	int nthreads;
+	vector<thread> threads;
+	vector<Worker *> workers;
+	mutex poolLock;
+	condition_variable wake;
+	condition_variable done;
+	function<void(int)> job;
+	function<void()> init;
+	int generation;
+	int busy;
+	bool stopping;
+	void workerMain(int id);
+	void runShare(int id);
+	bool take(int id, pair<int, int> &chunk);
+public:
+	WorkPool(int nthreads, function<void()> init = NULL);
+	virtual ~WorkPool();
+	int size();
+	void run(int n, function<void(int)> fn);
+};
+
+#endif /* _WORKPOOL_H_ */
@@ -28,6 +28,11 @@
 #include <fcntl.h>
 #include <execinfo.h>
 #include <signal.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
 #include <iostream>
 #include <vector>
 #include <map>
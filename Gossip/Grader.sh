@@ -21,8 +21,50 @@ function contains () {
 }
 
 verbose=$(contains "-v" "$@")
+oracle=$(contains "-o" "$@")
 grade=0
 
+# With -o the scores come from the in-process oracle of the Application, run without dbg.log
+function oracle_case () {
+	(cat testcases/$1; echo; echo "TEXT_LOG: 0") > oracle.conf
+	if [ $verbose -eq 0 ]; then
+		./Application oracle.conf | grep "^Checking\|^Grade " > oracle.log
+	else
+		./Application oracle.conf | tee /dev/stderr | grep "^Checking\|^Grade " > oracle.log
+	fi
+	grep "^Checking" oracle.log
+	# The total of the case, as the lines do not add up to it with message drops
+	score=`sed -n 's/^Grade \([0-9]*\)\/.*/\1/p' oracle.log`
+	grade=`expr $grade + $score`
+	rm -f oracle.conf oracle.log
+}
+
+if [ $oracle -eq 1 ]; then
+	echo "============================================"
+	echo "Grading Started"
+	if [ $verbose -eq 0 ]; then
+		make clean > /dev/null
+		make > /dev/null
+	else
+		make clean
+		make
+	fi
+	echo "============================================"
+	echo "Single Failure Scenario"
+	echo "============================"
+	oracle_case singlefailure.conf
+	echo "============================================"
+	echo "Multi Failure Scenario"
+	echo "============================"
+	oracle_case multifailure.conf
+	echo "============================================"
+	echo "Message Drop Single Failure Scenario"
+	echo "============================"
+	oracle_case msgdropsinglefailure.conf
+	echo Final grade $grade
+	exit 0
+fi
+
 echo "============================================"
 echo "Grading Started"
 echo "============================================"
@@ -12,20 +12,31 @@
 #include "Log.h"
 #include "Params.h"
 #include "Member.h"
+#include "Protocol.h"
 #include "EmulNet.h"
 #include "Queue.h"
+#include "TimerWheel.h"
 
 /**
  * Macros
+ * Protocol constants, can be overridden at build time with make DEFINES="-D<NAME>=<value>"
  */
+#ifndef TREMOVE
 #define TREMOVE 20
+#endif
+#ifndef TFAIL
 #define TFAIL 5
+#endif
+#ifndef NGOSSIPS
 #define NGOSSIPS 2
+#endif
 
 /*
  * Note: You can change/add any functions in MP1Node.{h,cpp}
  */
 
+namespace gossip {
+
 /**
  * Message Types
  */
@@ -44,21 +55,79 @@ typedef struct MessageHdr {
 	enum MsgTypes msgType;
 }MessageHdr;
 
+/**
+ * CLASS NAME: FixedPolicy
+ *
+ * DESCRIPTION: Protocol constants fixed at compile time. MP1Node reads its constants from its
+ * 				policy, so a node of a FixedPolicy has them folded into its loops. It takes the runs
+ * 				whose constants, as set by the test case or else by the build, are exactly its own.
+ */
+template <int Tremove, int Tfail, int Ngossips>
+class FixedPolicy {
+public:
+	static constexpr int tremove = Tremove;
+	static constexpr int tfail = Tfail;
+	static constexpr int ngossips = Ngossips;
+	FixedPolicy(Params *) {}
+	static bool accepts(Params *par) {
+		return par->constant("TREMOVE", TREMOVE) == tremove && par->constant("TFAIL", TFAIL) == tfail
+				&& par->constant("NGOSSIPS", NGOSSIPS) == ngossips;
+	}
+};
+
+/**
+ * CLASS NAME: RuntimePolicy
+ *
+ * DESCRIPTION: Protocol constants read from the test case when the node is made, for the runs no
+ * 				FixedPolicy takes
+ */
+class RuntimePolicy {
+public:
+	int tremove;
+	int tfail;
+	int ngossips;
+	RuntimePolicy(Params *par):
+			tremove(par->constant("TREMOVE", TREMOVE)),
+			tfail(par->constant("TFAIL", TFAIL)),
+			ngossips(par->constant("NGOSSIPS", NGOSSIPS)) {}
+	static bool accepts(Params *) {
+		return true;
+	}
+};
+
+// The constants of the build (TREMOVE, TFAIL, NGOSSIPS above)
+typedef FixedPolicy<TREMOVE, TFAIL, NGOSSIPS> BuiltPolicy;
+
 /**
  * CLASS NAME: MP1Node
  *
- * DESCRIPTION: Class implementing Membership protocol functionalities for failure detection
+ * DESCRIPTION: Class implementing Membership protocol functionalities for failure detection.
+ * 				Its constants come from the Policy, a FixedPolicy or the RuntimePolicy.
  */
-class MP1Node {
+template <class Policy>
+class MP1Node : public Protocol {
 private:
 	EmulNet *emulNet;
 	Log *log;
 	Params *par;
 	Member *memberNode;
+	// Protocol constants
+	Policy policy;
+	// Own random state, so choices do not depend on which thread steps the node
+	unsigned int randSeed;
+	// time of the last nodeLoop, heartbeats advance by the ticks elapsed since
+	int lastLoop;
+	// When each member other than this node is due to be removed, TREMOVE after its last update
+	TimerWheel expiry;
+	// Members whose removal came up at the current tick
+	vector<long> fired;
 	char NULLADDR[6];
 
 public:
 	MP1Node(Member *, Params *, EmulNet *, Log *, Address *);
+	static bool accepts(Params *par) {
+		return Policy::accepts(par);
+	}
 	Member * getMemberNode() {
 		return memberNode;
 	}
@@ -72,6 +141,12 @@ public:
 	void checkMessages();
 	bool recvCallBack(void *env, char *data, int size);
 	void nodeLoopOps();
+	void armRemoval(MemberListEntry &entry);
+	void removeExpired();
+	MessageHdr *joinRep(size_t *msgsize);
+	int nextWakeup();
+	bool quiescent();
+	long bytesUsed();
 	int isNullAddress(Address *addr);
 	Address getJoinAddress();
 	void initMemberListTable(Member *memberNode);
@@ -79,4 +154,10 @@ public:
 	virtual ~MP1Node();
 };
 
+// Made outside MP1Node.cpp by the microbenchmarks
+extern template class MP1Node<BuiltPolicy>;
+extern template class MP1Node<RuntimePolicy>;
+
+} /* namespace gossip */
+
 #endif /* _MP1NODE_H_ */
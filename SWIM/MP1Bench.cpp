@@ -0,0 +1,119 @@
+/**********************************
+ * FILE NAME: MP1Bench.cpp
+ *
+ * DESCRIPTION: Microbenchmarks of the hot functions of MP1Node, each run alone on a node whose
+ * 				membership list and payload hold 10 up to 100000 members.
+ * 				Build with make bench, run ./Bench [largest size].
+ **********************************/
+
+#include "MP1Node.h"
+#include "Bench.h"
+
+using namespace swim;
+
+/**
+ * FUNCTION NAME: fill
+ *
+ * DESCRIPTION: Put members 2 to size + 1 in the membership list and the payload of a node that
+ * 				just started at tick 0
+ */
+template <class Node>
+void fill(Node *node, int size) {
+	Member *member = node->getMemberNode();
+
+	for ( int i = 0; i < size; i++ ) {
+		MemberListEntry entry(i + 2, 0, 1, 0);
+		member->memberList.push_back(entry);
+		node->addPayload(PayloadMember(entry, true));
+	}
+}
+
+/**
+ * FUNCTION NAME: benchSize
+ *
+ * DESCRIPTION: Run every function at a size on a node of the given policy
+ */
+template <class Policy>
+void benchSize(Bench &bench, Params *par, EmulNet *en, Log *log, Address &self, int size) {
+	typedef MP1Node<Policy> Node;
+	Member *member = new Member();
+	Node *node = new Node(member, par, en, log, &self);
+	par->globaltime = 0;
+	node->initThisNode(&self);
+	fill(node, size);
+
+	// Lookups of members spread over the list, none of them newer than what the node has
+	int next = 0;
+	bench.run("findMember", size, [&]() {
+		node->findMember(MemberListEntry(next + 2, 0));
+		next = (next + BENCH_STRIDE) % size;
+	});
+	bench.run("findPayload", size, [&]() {
+		PayloadMember pay;
+		pay.id = next + 2;
+		node->findPayload(pay);
+		next = (next + BENCH_STRIDE) % size;
+	});
+
+	// A message piggybacking the whole payload, news to none of the lists
+	vector<char> message(sizeof(size_t) + size * sizeof(PayloadMember));
+	node->pushPayload(message.data());
+	if ( size <= BENCH_QUADRATIC_MAX ) {
+		bench.run("updateLists", size, [&]() {
+			node->updateLists(message.data());
+		});
+	}
+	else {
+		bench.skip("updateLists", size);
+	}
+	bench.run("pushPayload", size, [&]() {
+		node->pushPayload(message.data());
+	});
+
+	bench.run("refreshPayload/none due", size, [&]() {
+		node->refreshPayload();
+	});
+	bench.runEach("refreshPayload/all due", size, [&]() {
+		par->globaltime = 0;
+		node->initThisNode(&self);
+		fill(node, size);
+		par->globaltime = TREMOVE + 1;
+	}, [&]() {
+		node->refreshPayload();
+	});
+
+	bench.run("joinRep", size, [&]() {
+		size_t msgsize;
+		free(node->joinRep(&msgsize));
+	});
+
+	delete node;
+	delete member;
+}
+
+/**********************************
+ * FUNCTION NAME: main
+ *
+ * DESCRIPTION: Run every function at every size, on a node of the constants of the build and
+ * 				on one of the RuntimePolicy, whose lines end in /runtime
+ **********************************/
+int main(int argc, char *argv[]) {
+	int largest = argc > 1 ? atoi(argv[1]) : 100000;
+	Params *par = Bench::params();
+	Log *log = new Log(par);
+	EmulNet *en = new EmulNet(par);
+	Address self("1:0");
+	Bench bench;
+
+	for ( int size: Bench::sizes(largest) ) {
+		bench.variant("");
+		benchSize<BuiltPolicy>(bench, par, en, log, self, size);
+		bench.variant("/runtime");
+		benchSize<RuntimePolicy>(bench, par, en, log, self, size);
+	}
+
+	delete en;
+	delete log;
+	delete par;
+	return SUCCESS;
+}
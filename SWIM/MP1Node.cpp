@@ -11,12 +11,15 @@
  * Note: You can change/add any functions in MP1Node.{h,cpp}
  */
 
+namespace swim {
+
 /**
  * Overloaded Constructor of the MP1Node class
  * You can add new members to the class if you think it
  * is necessary for your logic to work
  */
-MP1Node::MP1Node(Member *member, Params *params, EmulNet *emul, Log *log, Address *address) {
+template <class Policy>
+MP1Node<Policy>::MP1Node(Member *member, Params *params, EmulNet *emul, Log *log, Address *address): policy(params), fiber(params) {
     for( int i = 0; i < 6; i++ ) {
         NULLADDR[i] = 0;
     }
@@ -25,14 +28,19 @@ MP1Node::MP1Node(Member *member, Params *params, EmulNet *emul, Log *log, Addres
     this->log = log;
     this->par = params;
     this->memberNode->addr = *address;
+    this->lastLoop = 0;
+    this->randSeed = params->SEED + 104729 * (*(int *)(address->addr));
     this->payload.clear();
-    this->checkPos = this->memberNode->memberList.end();
+    this->probeWait = WAIT_NONE;
+    this->probeSince = 0;
+    this->periodAt = -1;
 }
 
 /**
  * Destructor of the MP1Node class
  */
-MP1Node::~MP1Node() {}
+template <class Policy>
+MP1Node<Policy>::~MP1Node() {}
 
 /**
  * FUNCTION NAME: recvLoop
@@ -40,7 +48,8 @@ MP1Node::~MP1Node() {}
  * DESCRIPTION: This function receives message from the network and pushes into the queue
  *              This function is called by a node to receive messages currently waiting for it
  */
-int MP1Node::recvLoop() {
+template <class Policy>
+int MP1Node<Policy>::recvLoop() {
     if ( memberNode->bFailed ) {
         return false;
     }
@@ -54,9 +63,10 @@ int MP1Node::recvLoop() {
  *
  * DESCRIPTION: Enqueue the message from Emulnet into the queue
  */
-int MP1Node::enqueueWrapper(void *env, char *buff, int size) {
+template <class Policy>
+int MP1Node<Policy>::enqueueWrapper(void *env, char *buff, int size) {
     Queue q;
-    return q.enqueue((queue<q_elt> *)env, (void *)buff, size);
+    return q.enqueue((MessageQueue *)env, (void *)buff, size);
 }
 
 /**
@@ -66,7 +76,8 @@ int MP1Node::enqueueWrapper(void *env, char *buff, int size) {
  *              All initializations routines for a member.
  *              Called by the application layer.
  */
-void MP1Node::nodeStart(char *servaddrstr, short servport) {
+template <class Policy>
+void MP1Node<Policy>::nodeStart(char *servaddrstr, short servport) {
     Address joinaddr;
     joinaddr = getJoinAddress();
 
@@ -94,12 +105,11 @@ void MP1Node::nodeStart(char *servaddrstr, short servport) {
  *
  * DESCRIPTION: Find out who I am and start up
  */
-int MP1Node::initThisNode(Address *joinaddr) {
+template <class Policy>
+int MP1Node<Policy>::initThisNode(Address *joinaddr) {
     /*
      * This function is partially implemented and may require changes
      */
-    int id = *(int*)(&memberNode->addr.addr);
-    int port = *(short*)(&memberNode->addr.addr[4]);
 
     memberNode->bFailed = false;
     memberNode->inited = true;
@@ -107,9 +117,17 @@ int MP1Node::initThisNode(Address *joinaddr) {
     // node is up!
     memberNode->nnb = 0;
     memberNode->heartbeat = 0;
-    memberNode->pingCounter = TPING;
+    memberNode->pingCounter = policy.tping;
     memberNode->timeOutCounter = -1;
+    lastLoop = par->getcurrtime();
     initMemberListTable(memberNode);
+    // A rejoining node starts over with nothing to disseminate
+    payload.clear();
+    payloadExpiry.reset(par->getcurrtime());
+    // A rejoining node starts probing over
+    probeTarget = MemberListEntry();
+    periodAt = -1;
+    fiber.start(probeLoop());
 
     return 0;
 }
@@ -119,10 +137,11 @@ int MP1Node::initThisNode(Address *joinaddr) {
  *
  * DESCRIPTION: Join the distributed system
  */
-int MP1Node::introduceSelfToGroup(Address *joinaddr) {
+template <class Policy>
+int MP1Node<Policy>::introduceSelfToGroup(Address *joinaddr) {
     MessageHdr *msg;
 #ifdef DEBUGLOG
-    static char s[1024];
+    char s[1024];
 #endif
 
     if ( 0 == memcmp((char *)&(memberNode->addr.addr), (char *)&(joinaddr->addr), sizeof(memberNode->addr.addr))) {
@@ -137,7 +156,6 @@ int MP1Node::introduceSelfToGroup(Address *joinaddr) {
         short port = *(short*)(&memberNode->addr.addr[4]);
         MemberListEntry self(id, port, memberNode->heartbeat, par->getcurrtime());
         memberNode->memberList.push_back(self);
-        checkPos = memberNode->memberList.end();
 
         log->logNodeAdd(&(memberNode->addr), &(memberNode->addr));
     }
@@ -170,10 +188,12 @@ int MP1Node::introduceSelfToGroup(Address *joinaddr) {
  *
  * DESCRIPTION: Wind up this node and clean up state
  */
-int MP1Node::finishUpThisNode(){
+template <class Policy>
+int MP1Node<Policy>::finishUpThisNode(){
    /*
     * Your code goes here
     */
+    return SUCCESS;
 }
 
 /**
@@ -182,13 +202,15 @@ int MP1Node::finishUpThisNode(){
  * DESCRIPTION: Executed periodically at each member
  *              Check your messages in queue and perform membership protocol duties
  */
-void MP1Node::nodeLoop() {
+template <class Policy>
+void MP1Node<Policy>::nodeLoop() {
     if (memberNode->bFailed) {
         return;
     }
 
-    // Increase the heartbeat
-    memberNode->heartbeat++;
+    // Increase the heartbeat by the ticks since the last loop
+    memberNode->heartbeat += par->getcurrtime() - lastLoop;
+    lastLoop = par->getcurrtime();
 
     // Check my messages
     checkMessages();
@@ -209,7 +231,8 @@ void MP1Node::nodeLoop() {
  *
  * DESCRIPTION: Check messages in the queue and call the respective message handler
  */
-void MP1Node::checkMessages() {
+template <class Policy>
+void MP1Node<Policy>::checkMessages() {
     void *ptr;
     int size;
 
@@ -219,6 +242,7 @@ void MP1Node::checkMessages() {
         size = memberNode->mp1q.front().size;
         memberNode->mp1q.pop();
         recvCallBack((void *)memberNode, (char *)ptr, size);
+        Queue::release(ptr, size);
     }
     return;
 }
@@ -242,25 +266,67 @@ void addrToid(Address addr, int &id, short &port)
 /**
  * FUNCTION NAME: refreshPayload
  *
- * DESCRIPTION: Remove stale entries from payload
+ * DESCRIPTION: Remove stale entries from payload, keeping the order of the others. Only the
+ *              members whose entries came up in payloadExpiry are looked at.
  */
-void MP1Node::refreshPayload()
+template <class Policy>
+void MP1Node<Policy>::refreshPayload()
 {
-    for (auto it=payload.begin();it!=payload.end();)
+    payloadExpiry.expire(par->getcurrtime(), fired);
+    if (fired.empty())
+        return;
+    sort(fired.begin(), fired.end());
+
+    // Earliest drop left among the entries of each fired member, -1 if none is left
+    vector<int> dropAt(fired.size(), -1);
+    size_t kept = 0;
+    for (size_t i=0;i<payload.size();++i)
     {
-        if (par->getcurrtime() - it->timestamp > TREMOVE)
-            payload.erase(it);
-        else
-            it++;
+        auto f = lower_bound(fired.begin(), fired.end(), TimerWheel::key(payload[i].id, payload[i].port));
+        if (f != fired.end() and *f == TimerWheel::key(payload[i].id, payload[i].port))
+        {
+            if (par->getcurrtime() - payload[i].timestamp > policy.tremove)
+                continue;
+            int &at = dropAt[f - fired.begin()];
+            if (at < 0 or payload[i].timestamp + policy.tremove + 1 < at)
+                at = payload[i].timestamp + policy.tremove + 1;
+        }
+        payload[kept++] = payload[i];
+    }
+    payload.resize(kept);
+
+    for (size_t k=0;k<fired.size();++k)
+    {
+        if (dropAt[k] >= 0)
+            payloadExpiry.schedule(fired[k], dropAt[k]);
     }
 }
 
+/**
+ * FUNCTION NAME: addPayload
+ *
+ * DESCRIPTION: Append an entry to payload, to be dropped TREMOVE after its timestamp unless an
+ *              entry of the same member is due earlier
+ */
+template <class Policy>
+void MP1Node<Policy>::addPayload(PayloadMember pay)
+{
+    payload.push_back(pay);
+
+    long key = TimerWheel::key(pay.id, pay.port);
+    int dropAt = pay.timestamp + policy.tremove + 1;
+    int due = payloadExpiry.due(key);
+    if (due < 0 or dropAt < due)
+        payloadExpiry.schedule(key, dropAt);
+}
+
 /**
  * FUNCTION NAME: findPayload
  *
  * DESCRIPTION: Finds a payload entry
  */
-vector<PayloadMember>::iterator MP1Node::findPayload(PayloadMember pay)
+template <class Policy>
+PayloadList::iterator MP1Node<Policy>::findPayload(PayloadMember pay)
 {
     for (auto it=payload.begin();it!=payload.end();++it)
     {
@@ -271,6 +337,7 @@ vector<PayloadMember>::iterator MP1Node::findPayload(PayloadMember pay)
                 it->heartbeat = pay.heartbeat;
                 it->timestamp = par->getcurrtime();
                 it->status = pay.status;
+                // Its timer may now be early; refreshPayload sets it again when it fires
             }
             return it;
         }
@@ -283,7 +350,8 @@ vector<PayloadMember>::iterator MP1Node::findPayload(PayloadMember pay)
  *
  * DESCRIPTION: Finds a memberlist entry
  */
-vector<MemberListEntry>::iterator MP1Node::findMember(MemberListEntry mem)
+template <class Policy>
+MemberList::iterator MP1Node<Policy>::findMember(MemberListEntry mem)
 {
     for (auto it=memberNode->memberList.begin();it!=memberNode->memberList.end();++it)
     {
@@ -305,31 +373,22 @@ vector<MemberListEntry>::iterator MP1Node::findMember(MemberListEntry mem)
  *
  * DESCRIPTION: Add entries recieved as payload from the message
  */
-void MP1Node::updateLists(char *curr)
+template <class Policy>
+void MP1Node<Policy>::updateLists(char *curr)
 {
     // Find size of recieved payload
     size_t sizeList;
     memcpy((char *)&sizeList, curr, sizeof(sizeList));
     curr += sizeof(sizeList);
 
-    int nocheckPos = 0, id;
-    short port;
-    if (checkPos == memberNode->memberList.end())
-        nocheckPos = 1;
-    else
-    {
-        id = checkPos->id;
-        port = checkPos->port;
-    }
-
-    for (int i=0;i<sizeList;++i)
+    for (size_t i=0;i<sizeList;++i)
     {
         // Insert to payload if doesn't exist already
         PayloadMember pay;
         memcpy((char *)&pay, curr, sizeof(pay));
         curr += sizeof(pay);
         if (findPayload(pay) == payload.end())
-            payload.push_back(pay);
+            addPayload(pay);
 
         // Insert to/ Delete from memberList
         MemberListEntry mem(pay.id, pay.port, pay.heartbeat, par->getcurrtime());
@@ -345,12 +404,6 @@ void MP1Node::updateLists(char *curr)
             log->logNodeRemove(&(memberNode->addr), &address);
         }
     }
-
-    // Put checkPos at end if it was at the end before
-    if (nocheckPos)
-        checkPos = memberNode->memberList.end();
-    else
-        checkPos = findMember(MemberListEntry (id, port));
 }
 
 /**
@@ -358,41 +411,56 @@ void MP1Node::updateLists(char *curr)
  *
  * DESCRIPTION: Push your payload onto the message
  */
-void MP1Node::pushPayload(char *msg)
+template <class Policy>
+void MP1Node<Policy>::pushPayload(char *msg)
 {
     size_t sizeList = payload.size();
     memcpy(msg, (char *)&sizeList, sizeof(sizeList));
     msg += sizeof(sizeList);
 
-    for (int i=0;i<sizeList;++i)
+    for (size_t i=0;i<sizeList;++i)
     {
         memcpy(msg, (char *)&(payload[i]), sizeof(PayloadMember));
         msg += sizeof(PayloadMember);
     }
 }
 
+/**
+ * FUNCTION NAME: joinRep
+ *
+ * DESCRIPTION: Build the JOINREP message carrying the membership list, for the caller to free
+ */
+template <class Policy>
+MessageHdr *MP1Node<Policy>::joinRep(size_t *msgsize)
+{
+    size_t sizeList = memberNode->memberList.size();
+    *msgsize = sizeof(MessageHdr) + sizeof(sizeList) + sizeList * sizeof(MemberListEntry);
+    MessageHdr *msg = (MessageHdr *) malloc(*msgsize * sizeof(char));
+
+    msg->msgType = JOINREP;
+    memcpy((char *)(msg+1), (char *)&(sizeList), sizeof(sizeList));
+    char *curr = (char *)(msg+1) + sizeof(sizeList);
+    for (auto entry: memberNode->memberList)
+    {
+        memcpy(curr, (char *)&(entry), sizeof(entry));
+        curr = curr + sizeof(entry);
+    }
+    return msg;
+}
+
 /**
  * FUNCTION NAME: recvCallBack
  *
  * DESCRIPTION: Message handler for different message types
  */
-bool MP1Node::recvCallBack(void *env, char *data, int size ) {
+template <class Policy>
+bool MP1Node<Policy>::recvCallBack(void *env, char *data, int size ) {
     Member *node = (Member *)env;
     enum MsgTypes type = ((MessageHdr *)data)->msgType;
     char *curr = (char *)((MessageHdr *)data+1);
 
     if (type == JOINREQ)
     {
-        int nocheckPos = 0, idO;
-        short portO;
-        if (checkPos == memberNode->memberList.end())
-            nocheckPos = 1;
-        else
-        {
-            idO = checkPos->id;
-            portO = checkPos->port;
-        }
-
         // Add new node in coordinator's membership list
         Address address;
         long heartbeat;
@@ -402,33 +470,21 @@ bool MP1Node::recvCallBack(void *env, char *data, int size ) {
         int id = *(int*)(address.addr);
         int port = *(short*)(address.addr+4);
 
+        // A repeated JOINREQ must not add the node twice
         MemberListEntry newMember(id, port, heartbeat, par->getcurrtime());
-        node->memberList.push_back(newMember);
-
-        payload.push_back(PayloadMember (newMember, true));
+        if (findMember(newMember) == node->memberList.end())
+        {
+            node->memberList.push_back(newMember);
 
-        // Create a log for added node
-        log->logNodeAdd(&(node->addr), &(address));
+            addPayload(PayloadMember (newMember, true));
 
-        // Create a JOINREP message for new node
-        size_t sizeList = node->memberList.size();
-        size_t msgsize = sizeof(MessageHdr) + sizeof(sizeList) + sizeList * sizeof(MemberListEntry);
-        MessageHdr *msg = (MessageHdr *) malloc(msgsize * sizeof(char));
-
-        msg->msgType = JOINREP;
-        memcpy((char *)(msg+1), (char *)&(sizeList), sizeof(sizeList));
-        char *top = (char *)(msg+1) + sizeof(sizeList);
-        for (auto entry: node->memberList)
-        {
-            memcpy(top, (char *)&(entry), sizeof(entry));
-            top = top + sizeof(entry);
+            // Create a log for added node
+            log->logNodeAdd(&(node->addr), &(address));
         }
 
-        // Put checkPos at end if it was at the end before
-        if (nocheckPos)
-            checkPos = memberNode->memberList.end();
-        else
-            checkPos = findMember(MemberListEntry (idO, portO));
+        // Create a JOINREP message for new node
+        size_t msgsize;
+        MessageHdr *msg = joinRep(&msgsize);
 
         // Send JOINREP to newly added node
         emulNet->ENsend(&(node->addr), &address, (char *)msg, msgsize);
@@ -447,22 +503,24 @@ bool MP1Node::recvCallBack(void *env, char *data, int size ) {
         curr = curr + sizeof(sizeList);
 
         MemberListEntry newEntry;
-        for (int i=0;i<sizeList;++i)
+        for (size_t i=0;i<sizeList;++i)
         {
             memcpy((char *)&newEntry, curr, sizeof(newEntry));
             curr = curr + sizeof(newEntry);
             newEntry.timestamp = par->getcurrtime();
+
+            // Skip members already learnt from piggybacked payloads
+            if (findMember(newEntry) != node->memberList.end())
+                continue;
             node->memberList.push_back(newEntry);
 
             PayloadMember pay(newEntry, true);
-            payload.push_back(pay);
+            addPayload(pay);
 
             Address address = idTOaddr(newEntry.id, newEntry.port);
 
             log->logNodeAdd(&(node->addr), &(address));
         }
-
-        checkPos = memberNode->memberList.end();
     }
     else if (type == PING)
     {
@@ -515,10 +573,11 @@ bool MP1Node::recvCallBack(void *env, char *data, int size ) {
             return 1;
         }
 
-        // Check if the recieved ACK is from required node
-        if (checkPos != node->memberList.end() and acker == idTOaddr(checkPos->id, checkPos->port))
+        // Check if the recieved ACK is from the member probed last
+        auto it = findMember(MemberListEntry (probeTarget.id, probeTarget.port));
+        if (probeTarget.id != 0 and it != node->memberList.end() and acker == idTOaddr(it->id, it->port))
         {
-            checkPos->timestamp = par->getcurrtime();
+            it->timestamp = par->getcurrtime();
         }
     }
     else if (type == PING_REQ)
@@ -554,105 +613,259 @@ bool MP1Node::recvCallBack(void *env, char *data, int size ) {
 
         free(msgHead);
     }
+    return true;
 }
 
 /**
  * FUNCTION NAME: nodeLoopOps
  *
- * DESCRIPTION: Check if any node hasn't responded within a timeout period and then delete
- *              the nodes
- *              Propagate your membership list
+ * DESCRIPTION: Wake the probe loop if what it waits on happened in the messages just handled,
+ *              then let it run if it was woken or its period came
  */
-void MP1Node::nodeLoopOps() {
-    // Update your own heartbeat
-    MemberListEntry mem;
-    addrToid(memberNode->addr, mem.id, mem.port);
-    auto it = findMember(mem);
+template <class Policy>
+void MP1Node<Policy>::nodeLoopOps() {
+    bool ready = false;
 
-    if (memberNode->heartbeat % TPING == 0 and memberNode->memberList.size() > 1)
+    if (probeWait == WAIT_GROUP)
+    {
+        // nodeLoop only gets here once the node is in the group
+        ready = true;
+    }
+    else if (probeWait == WAIT_MEMBERS)
+    {
+        ready = memberNode->memberList.size() > 1;
+    }
+    else if (probeWait == WAIT_REPLY)
     {
-        if (checkPos == memberNode->memberList.end() or par->getcurrtime() - checkPos->timestamp < TPING)
+        // An ACK, or gossip with a newer heartbeat, refreshes the target's timestamp
+        auto it = findMember(MemberListEntry (probeTarget.id, probeTarget.port));
+        ready = it == memberNode->memberList.end() or it->timestamp > probeSince;
+    }
+
+    if (ready)
+    {
+        probeWait = WAIT_NONE;
+        fiber.wake();
+    }
+    fiber.step();
+
+    return;
+}
+
+/**
+ * FUNCTION NAME: probeLoop
+ *
+ * DESCRIPTION: Failure detection of SWIM, one probe round after the other. Every round starts at a
+ *              protocol period (a heartbeat that is a multiple of TPING): ping a random member,
+ *              if it did not answer by the next period ask FORWARD_PINGERS others to ping it,
+ *              and if it is still silent one period later declare it failed. A member that
+ *              answered or left the list ends the round, the next one starts at the next period.
+ */
+template <class Policy>
+Task MP1Node<Policy>::probeLoop() {
+    // Nothing to probe before joining the group
+    probeWait = WAIT_GROUP;
+    co_await fiber.event();
+
+    for (;;)
+    {
+        co_await fiber.until(nextPeriod());
+        if (memberNode->memberList.size() <= 1)
         {
-            // Find a node other than itself to ping
-            checkPos = memberNode->memberList.begin() + rand()%memberNode->memberList.size();
-            while (idTOaddr(checkPos->id, checkPos->port) == memberNode->addr)
-            {
-                checkPos = memberNode->memberList.begin() + rand()%memberNode->memberList.size();
-            }
-            checkPos->timestamp = par->getcurrtime();
+            // Nobody to probe until somebody else joins
+            probeWait = WAIT_MEMBERS;
+            co_await fiber.event();
+            continue;
+        }
 
-            // Remove the expired elements
-            refreshPayload();
+        MemberListEntry target = pickTarget();
+        sendPing(target);
+        if (co_await reply(target))
+            continue;
 
-            // Prepare the PING message to send
-            size_t sizeList = payload.size();
-            int msgsize = sizeof(MessageHdr) + sizeof(Address)
-                            + sizeof(sizeList) + sizeList * sizeof(PayloadMember);
-            MessageHdr *msgHead = (MessageHdr *) malloc(msgsize * sizeof(char));
-            msgHead->msgType = PING;
+        co_await fiber.until(nextPeriod());
+        sendPingReqs(target);
+        if (co_await reply(target))
+            continue;
 
-            // Add your address on the PING
-            memcpy((char *)(msgHead+1), (char *)&(memberNode->addr), sizeof(Address));
+        co_await fiber.until(nextPeriod());
+        declareFailed(target);
+    }
+}
 
-            // Push your payload data
-            pushPayload((char *)(msgHead+1) + sizeof(Address));
+/**
+ * FUNCTION NAME: nextPeriod
+ *
+ * DESCRIPTION: The current tick if it is a protocol period the probe loop has not acted at yet,
+ *              else the next protocol period. The probe loop acts at the tick returned.
+ */
+template <class Policy>
+int MP1Node<Policy>::nextPeriod() {
+    probeWait = WAIT_NONE;
+    int period = par->getcurrtime() + (policy.tping - (int)(memberNode->heartbeat % policy.tping)) % policy.tping;
+    if (period == periodAt)
+        period += policy.tping;
+    periodAt = period;
+    return period;
+}
 
-            // Send PING message to the dest
-            Address target = idTOaddr(checkPos->id, checkPos->port);
-            emulNet->ENsend(&(memberNode->addr), &target, (char *)msgHead, msgsize);
-        }
-        else if (par->getcurrtime() - checkPos->timestamp >= TPING and
-                    par->getcurrtime() - checkPos->timestamp < 2*TPING)
-        {
-            // Remove the expired elements
-            refreshPayload();
+/**
+ * FUNCTION NAME: reply
+ *
+ * DESCRIPTION: co_await this to wait until the target answers or leaves the member list, or
+ *              until the next protocol period if it does not
+ */
+template <class Policy>
+Fiber::Wait MP1Node<Policy>::reply(MemberListEntry &target) {
+    probeWait = WAIT_REPLY;
+    probeTarget = target;
+    probeSince = par->getcurrtime();
+    return fiber.event(par->getcurrtime() + policy.tping - (int)(memberNode->heartbeat % policy.tping));
+}
 
-            int maxpingers = max(0, (min(FORWARD_PINGERS, (int)memberNode->memberList.size()-2)));
-            vector<MemberListEntry> Fpingers(maxpingers);
-            for (int i=0;i<maxpingers;++i)
-            {
-                Fpingers[i] = memberNode->memberList[rand() % memberNode->memberList.size()];
-                while ((Fpingers[i].id == checkPos->id and Fpingers[i].port == checkPos->port) or
-                        idTOaddr(Fpingers[i].id, Fpingers[i].port) == memberNode->addr)
-                    Fpingers[i] = memberNode->memberList[rand()%memberNode->memberList.size()];
-            }
+/**
+ * FUNCTION NAME: pickTarget
+ *
+ * DESCRIPTION: Pick a random member other than this node to probe
+ */
+template <class Policy>
+MemberListEntry MP1Node<Policy>::pickTarget() {
+    auto it = memberNode->memberList.begin() + rand_r(&randSeed)%memberNode->memberList.size();
+    while (idTOaddr(it->id, it->port) == memberNode->addr)
+    {
+        it = memberNode->memberList.begin() + rand_r(&randSeed)%memberNode->memberList.size();
+    }
+    it->timestamp = par->getcurrtime();
+    return *it;
+}
 
-            // Prepare the PING_REQ message to send
-            size_t sizeList = payload.size();
-            int msgsize = sizeof(MessageHdr) + 2 * sizeof(Address)
-                            + sizeof(sizeList) + sizeList * sizeof(PayloadMember);
-            MessageHdr *msgHead = (MessageHdr *) malloc(msgsize * sizeof(char));
-            msgHead->msgType = PING_REQ;
+/**
+ * FUNCTION NAME: sendPing
+ *
+ * DESCRIPTION: Ping the target directly
+ */
+template <class Policy>
+void MP1Node<Policy>::sendPing(MemberListEntry &target) {
+    // Remove the expired elements
+    refreshPayload();
 
-            // Add addresses on the PING_REQ
-            memcpy((char *)(msgHead+1), (char *)&(memberNode->addr), sizeof(Address));
-            Address target = idTOaddr(checkPos->id, checkPos->port);
-            memcpy((char *)(msgHead+1) + sizeof(Address), (char *)&target, sizeof(Address));
+    // Prepare the PING message to send
+    size_t sizeList = payload.size();
+    int msgsize = sizeof(MessageHdr) + sizeof(Address)
+                    + sizeof(sizeList) + sizeList * sizeof(PayloadMember);
+    MessageHdr *msgHead = (MessageHdr *) malloc(msgsize * sizeof(char));
+    msgHead->msgType = PING;
 
-            // Push your payload data
-            pushPayload((char *)(msgHead+1) + 2 * sizeof(Address));
+    // Add your address on the PING
+    memcpy((char *)(msgHead+1), (char *)&(memberNode->addr), sizeof(Address));
 
-            // Send PING_REQ message to the forwarders
-            for (int i=0;i<maxpingers;++i)
-            {
-                Address forwarder = idTOaddr(Fpingers[i].id, Fpingers[i].port);
-                emulNet->ENsend(&(memberNode->addr), &forwarder, (char *)msgHead, msgsize);
-            }
-        }
-        else
-        {
-            PayloadMember pay(*checkPos, false);
-            payload.push_back(pay);
+    // Push your payload data
+    pushPayload((char *)(msgHead+1) + sizeof(Address));
 
-            Address address = idTOaddr(checkPos->id, checkPos->port);
-            log->logNodeRemove(&(memberNode->addr), &address);
+    // Send PING message to the dest
+    Address dest = idTOaddr(target.id, target.port);
+    emulNet->ENsend(&(memberNode->addr), &dest, (char *)msgHead, msgsize);
 
-            memberNode->memberList.erase(checkPos);
-            checkPos = memberNode->memberList.end();
-        }
+    free(msgHead);
+}
+
+/**
+ * FUNCTION NAME: sendPingReqs
+ *
+ * DESCRIPTION: Ask random members other than this node and the target to ping the target
+ */
+template <class Policy>
+void MP1Node<Policy>::sendPingReqs(MemberListEntry &target) {
+    // Remove the expired elements
+    refreshPayload();
+
+    int maxpingers = max(0, (min(policy.forwardPingers, (int)memberNode->memberList.size()-2)));
+    vector<MemberListEntry> Fpingers(maxpingers);
+    for (int i=0;i<maxpingers;++i)
+    {
+        Fpingers[i] = memberNode->memberList[rand_r(&randSeed) % memberNode->memberList.size()];
+        while ((Fpingers[i].id == target.id and Fpingers[i].port == target.port) or
+                idTOaddr(Fpingers[i].id, Fpingers[i].port) == memberNode->addr)
+            Fpingers[i] = memberNode->memberList[rand_r(&randSeed)%memberNode->memberList.size()];
     }
 
-    return;
+    // Prepare the PING_REQ message to send
+    size_t sizeList = payload.size();
+    int msgsize = sizeof(MessageHdr) + 2 * sizeof(Address)
+                    + sizeof(sizeList) + sizeList * sizeof(PayloadMember);
+    MessageHdr *msgHead = (MessageHdr *) malloc(msgsize * sizeof(char));
+    msgHead->msgType = PING_REQ;
+
+    // Add addresses on the PING_REQ
+    memcpy((char *)(msgHead+1), (char *)&(memberNode->addr), sizeof(Address));
+    Address dest = idTOaddr(target.id, target.port);
+    memcpy((char *)(msgHead+1) + sizeof(Address), (char *)&dest, sizeof(Address));
+
+    // Push your payload data
+    pushPayload((char *)(msgHead+1) + 2 * sizeof(Address));
+
+    // Send PING_REQ message to the forwarders
+    for (int i=0;i<maxpingers;++i)
+    {
+        Address forwarder = idTOaddr(Fpingers[i].id, Fpingers[i].port);
+        emulNet->ENsend(&(memberNode->addr), &forwarder, (char *)msgHead, msgsize);
+    }
+
+    free(msgHead);
+}
+
+/**
+ * FUNCTION NAME: declareFailed
+ *
+ * DESCRIPTION: Remove the silent target and disseminate its failure
+ */
+template <class Policy>
+void MP1Node<Policy>::declareFailed(MemberListEntry &target) {
+    auto it = findMember(MemberListEntry (target.id, target.port));
+
+    PayloadMember pay(*it, false);
+    addPayload(pay);
+
+    Address address = idTOaddr(it->id, it->port);
+    log->logNodeRemove(&(memberNode->addr), &address);
+
+    memberNode->memberList.erase(it);
+    probeTarget = MemberListEntry();
+}
+
+/**
+ * FUNCTION NAME: nextWakeup
+ *
+ * DESCRIPTION: Time of the next tick at which the probe loop has work to do, or -1 if the node
+ *              only needs to run when a message arrives
+ */
+template <class Policy>
+int MP1Node<Policy>::nextWakeup() {
+    if (memberNode->bFailed) {
+        return -1;
+    }
+    return fiber.nextWakeup();
+}
+
+/**
+ * FUNCTION NAME: quiescent
+ *
+ * DESCRIPTION: True if the node has no updates left to piggyback, so its messages carry no news
+ */
+template <class Policy>
+bool MP1Node<Policy>::quiescent() {
+    return payload.empty();
+}
+
+/**
+ * FUNCTION NAME: bytesUsed
+ *
+ * DESCRIPTION: Bytes held by this node's membership list, queue, piggybacked updates and their
+ *              timers
+ */
+template <class Policy>
+long MP1Node<Policy>::bytesUsed() {
+    return memberNode->bytesUsed() + payload.capacity() * sizeof(PayloadMember) + payloadExpiry.bytesUsed();
 }
 
 /**
@@ -660,7 +873,8 @@ void MP1Node::nodeLoopOps() {
  *
  * DESCRIPTION: Function checks if the address is NULL
  */
-int MP1Node::isNullAddress(Address *addr) {
+template <class Policy>
+int MP1Node<Policy>::isNullAddress(Address *addr) {
     return (memcmp(addr->addr, NULLADDR, 6) == 0 ? 1 : 0);
 }
 
@@ -669,10 +883,11 @@ int MP1Node::isNullAddress(Address *addr) {
  *
  * DESCRIPTION: Returns the Address of the coordinator
  */
-Address MP1Node::getJoinAddress() {
+template <class Policy>
+Address MP1Node<Policy>::getJoinAddress() {
     Address joinaddr;
 
-    memset(&joinaddr, 0, sizeof(Address));
+    memset(joinaddr.addr, 0, sizeof(joinaddr.addr));
     *(int *)(&joinaddr.addr) = 1;
     *(short *)(&joinaddr.addr[4]) = 0;
 
@@ -684,7 +899,8 @@ Address MP1Node::getJoinAddress() {
  *
  * DESCRIPTION: Initialize the membership list
  */
-void MP1Node::initMemberListTable(Member *memberNode) {
+template <class Policy>
+void MP1Node<Policy>::initMemberListTable(Member *memberNode) {
     memberNode->memberList.clear();
 }
 
@@ -693,8 +909,25 @@ void MP1Node::initMemberListTable(Member *memberNode) {
  *
  * DESCRIPTION: Print the Address
  */
-void MP1Node::printAddress(Address *addr)
+template <class Policy>
+void MP1Node<Policy>::printAddress(Address *addr)
 {
     printf("%d.%d.%d.%d:%d \n",  addr->addr[0],addr->addr[1],addr->addr[2],
                                                        addr->addr[3], *(short*)&addr->addr[4]) ;    
 }
+
+/*
+ * Selected by PROTOCOL: SWIM. The first whose policy takes the run's constants is made: the
+ * build's, then common settings of them, then the RuntimePolicy for any other.
+ */
+static ProtocolRegistrar<MP1Node<BuiltPolicy> > built("SWIM");
+// A probe every tick
+static ProtocolRegistrar<MP1Node<FixedPolicy<6, 1, 3> > > probeEveryTick("SWIM");
+// More indirect probes, for lossy links
+static ProtocolRegistrar<MP1Node<FixedPolicy<6, 2, 5> > > lossyLinks("SWIM");
+static ProtocolRegistrar<MP1Node<RuntimePolicy> > anyConstants("SWIM");
+
+template class MP1Node<BuiltPolicy>;
+template class MP1Node<RuntimePolicy>;
+
+} /* namespace swim */
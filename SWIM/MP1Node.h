@@ -12,20 +12,32 @@
 #include "Log.h"
 #include "Params.h"
 #include "Member.h"
+#include "Protocol.h"
 #include "EmulNet.h"
 #include "Queue.h"
+#include "Fiber.h"
+#include "TimerWheel.h"
 
 /**
  * Macros
+ * Protocol constants, can be overridden at build time with make DEFINES="-D<NAME>=<value>"
  */
+#ifndef TREMOVE
 #define TREMOVE 6
+#endif
+#ifndef TPING
 #define TPING 2
+#endif
+#ifndef FORWARD_PINGERS
 #define FORWARD_PINGERS 3
+#endif
 
 /*
  * Note: You can change/add any functions in MP1Node.{h,cpp}
  */
 
+namespace swim {
+
 /**
  * Message Types
  */
@@ -44,6 +56,16 @@ enum MsgTypes{
  * PING-REQ: MsgType + Pinger.Address + Dest.Address + PayloadSize + Payload
  */
 
+/**
+ * What the probe loop is suspended on besides a protocol period
+ */
+enum ProbeWaits{
+    WAIT_NONE,
+    WAIT_GROUP,
+    WAIT_MEMBERS,
+    WAIT_REPLY,
+};
+
 /**
  * STRUCT NAME: MessageHdr
  *
@@ -76,23 +98,92 @@ public:
 	}
 };
 
+// Piggybacked updates, accounted as such
+typedef vector<PayloadMember, Counted<PayloadMember, MEM_PAYLOAD> > PayloadList;
+
+/**
+ * CLASS NAME: FixedPolicy
+ *
+ * DESCRIPTION: Protocol constants fixed at compile time. MP1Node reads its constants from its
+ * 				policy, so a node of a FixedPolicy has them folded into its loops. It takes the runs
+ * 				whose constants, as set by the test case or else by the build, are exactly its own.
+ */
+template <int Tremove, int Tping, int ForwardPingers>
+class FixedPolicy {
+public:
+	static constexpr int tremove = Tremove;
+	static constexpr int tping = Tping;
+	static constexpr int forwardPingers = ForwardPingers;
+	FixedPolicy(Params *) {}
+	static bool accepts(Params *par) {
+		return par->constant("TREMOVE", TREMOVE) == tremove && par->constant("TPING", TPING) == tping
+				&& par->constant("FORWARD_PINGERS", FORWARD_PINGERS) == forwardPingers;
+	}
+};
+
+/**
+ * CLASS NAME: RuntimePolicy
+ *
+ * DESCRIPTION: Protocol constants read from the test case when the node is made, for the runs no
+ * 				FixedPolicy takes
+ */
+class RuntimePolicy {
+public:
+	int tremove;
+	int tping;
+	int forwardPingers;
+	RuntimePolicy(Params *par):
+			tremove(par->constant("TREMOVE", TREMOVE)),
+			tping(max(1, par->constant("TPING", TPING))),
+			forwardPingers(par->constant("FORWARD_PINGERS", FORWARD_PINGERS)) {}
+	static bool accepts(Params *) {
+		return true;
+	}
+};
+
+// The constants of the build (TREMOVE, TPING, FORWARD_PINGERS above)
+typedef FixedPolicy<TREMOVE, TPING, FORWARD_PINGERS> BuiltPolicy;
+
 /**
  * CLASS NAME: MP1Node
  *
- * DESCRIPTION: Class implementing Membership protocol functionalities for failure detection
+ * DESCRIPTION: Class implementing Membership protocol functionalities for failure detection.
+ * 				Its constants come from the Policy, a FixedPolicy or the RuntimePolicy.
  */
-class MP1Node {
+template <class Policy>
+class MP1Node : public Protocol {
 private:
 	EmulNet *emulNet;
 	Log *log;
 	Params *par;
 	Member *memberNode;
-	vector<PayloadMember> payload;
-	vector<MemberListEntry>::iterator checkPos;
+	// Protocol constants
+	Policy policy;
+	// Own random state, so choices do not depend on which thread steps the node
+	unsigned int randSeed;
+	PayloadList payload;
+	// When the entries of each member in payload are due to be dropped, TREMOVE after their update
+	TimerWheel payloadExpiry;
+	// Members whose payload entries came up at the current tick
+	vector<long> fired;
+	// Runs probeLoop
+	Fiber fiber;
+	// What probeLoop waits on, for nodeLoopOps to wake it
+	enum ProbeWaits probeWait;
+	// Member probed last, id 0 if none, and the tick the wait for its reply began
+	MemberListEntry probeTarget;
+	int probeSince;
+	// Protocol period the probe loop last acted at
+	int periodAt;
+	// time of the last nodeLoop, heartbeats advance by the ticks elapsed since
+	int lastLoop;
 	char NULLADDR[6];
 
 public:
 	MP1Node(Member *, Params *, EmulNet *, Log *, Address *);
+	static bool accepts(Params *par) {
+		return Policy::accepts(par);
+	}
 	Member * getMemberNode() {
 		return memberNode;
 	}
@@ -106,16 +197,34 @@ public:
 	void checkMessages();
 	bool recvCallBack(void *env, char *data, int size);
 	void nodeLoopOps();
+	Task probeLoop();
+	int nextPeriod();
+	Fiber::Wait reply(MemberListEntry &target);
+	MemberListEntry pickTarget();
+	void sendPing(MemberListEntry &target);
+	void sendPingReqs(MemberListEntry &target);
+	void declareFailed(MemberListEntry &target);
+	int nextWakeup();
+	bool quiescent();
+	long bytesUsed();
 	int isNullAddress(Address *addr);
 	Address getJoinAddress();
 	void initMemberListTable(Member *memberNode);
 	void printAddress(Address *addr);
 	void refreshPayload();
-	vector<PayloadMember>::iterator findPayload(PayloadMember pay);
-	vector<MemberListEntry>::iterator findMember(MemberListEntry mem);
+	void addPayload(PayloadMember pay);
+	PayloadList::iterator findPayload(PayloadMember pay);
+	MemberList::iterator findMember(MemberListEntry mem);
 	void updateLists(char *curr);
 	void pushPayload(char *msg);
+	MessageHdr *joinRep(size_t *msgsize);
 	virtual ~MP1Node();
 };
 
+// Made outside MP1Node.cpp by the microbenchmarks
+extern template class MP1Node<BuiltPolicy>;
+extern template class MP1Node<RuntimePolicy>;
+
+} /* namespace swim */
+
 #endif /* _MP1NODE_H_ */
@@ -13,8 +13,13 @@
 # 20191024: Packaging the needed files directly to remove download dependency,
 #   adding more error checking for the environment setup
 
-if [ ! -e "Application.cpp" ]; then
-  echo -e '\n\nERROR: This script "run.sh" should be located in the same directory where the Application.cpp file is.\n\n'
+if [ ! -e "MP1Node.cpp" ]; then
+  echo -e '\n\nERROR: This script "run.sh" should be located in the same directory where the MP1Node.cpp file is.\n\n'
+  exit 1
+fi
+
+if [ ! -d "../Emulator" ]; then
+  echo -e '\n\nERROR: The "Emulator" directory was not found next to this directory. The protocol is built against it.\n\n'
   exit 1
 fi
 
@@ -47,8 +52,12 @@ cd grade-dir
 cp ../mp1-regen-data mp1-regen-data-tmp.tar
 tar -xf mp1-regen-data-tmp.tar
 
+# The stock package only provides the test cases: MP1Node uses the shared emulator, so the stock
+# sources are removed and it is built with this tree's Makefile against a copy of ../Emulator
+cp -R ../../Emulator Emulator
 cd mp1
-cp ../../MP1Node.* .
+rm -f *.cpp *.h Makefile
+cp ../../MP1Node.* ../../Makefile .
 make clean > /dev/null
 make > /dev/null
 
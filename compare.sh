@@ -0,0 +1,130 @@
+#!/usr/bin/env bash
+
+#**********************
+#*
+#* Progam Name: MP1. Membership Protocol.
+#*
+#* Current file: compare.sh
+#* About this file: Protocol comparison script.
+#*
+#***********************
+
+# Runs All to All, Gossip and SWIM on the same test cases and writes one table that compares
+# their cost and detection quality, averaged over the seeds, to <outdir>/compare.txt.
+#
+#   ./compare.sh [-j jobs] [-o outdir] [-c base.conf] [-t seconds] [-m MB] [KEY=v1,v2,... ...]
+#
+# Every protocol runs the base test case (SWIM/testcases/msgdropsinglefailure.conf unless -c
+# names another one) with seeds 1 to 5, so for a given seed the three see the same join
+# schedule and the same crashes. The test case gets DROP_BY_LINK: 1, which makes the drop of a
+# message depend on the seed, the link, the tick and the messages sent on that link before it
+# in the tick rather than on all the traffic of the sender: two protocols sending on the same
+# link at the same tick lose the same messages. Text logs are off. The grid is
+# PROTOCOL=AllToAll,Gossip,SWIM SEED=1,2,3,4,5; a key given on the command line replaces its
+# default or adds a dimension, as in sweep.sh, which runs the grid and leaves the table of every
+# single run in <outdir>/results.txt and <outdir>/results.csv.
+#
+# compare.txt has one row per protocol and point of the other keys: the runs that finished, the
+# sum of their grades, the means of messages, bytes, cpu_s, first_p50, full_p50 and full_p99
+# over them, and the totals of missed detections and false removals.
+
+cd "$(dirname "$0")"
+
+jobs=$(nproc 2>/dev/null || echo 2)
+outdir=compare-out
+base=SWIM/testcases/msgdropsinglefailure.conf
+timelimit=""
+memlimit=""
+
+while getopts "j:o:c:t:m:" opt; do
+	case $opt in
+		j) jobs=$OPTARG ;;
+		o) outdir=$OPTARG ;;
+		c) base=$OPTARG ;;
+		t) timelimit=$OPTARG ;;
+		m) memlimit=$OPTARG ;;
+		*) echo "usage: $0 [-j jobs] [-o outdir] [-c base.conf] [-t seconds] [-m MB] [KEY=v1,v2,... ...]"; exit 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+if [ ! -e "$base" ]; then
+	echo "Base test case $base not found"
+	exit 1
+fi
+
+# Default grid, then the command line keys in their order
+keys=(PROTOCOL SEED)
+declare -A grid=([PROTOCOL]=AllToAll,Gossip,SWIM [SEED]=1,2,3,4,5)
+for arg in "$@"; do
+	key=${arg%%=*}
+	if [ -z "${grid[$key]+set}" ]; then
+		keys+=("$key")
+	fi
+	grid[$key]=${arg#*=}
+done
+args=()
+for key in "${keys[@]}"; do
+	args+=("$key=${grid[$key]}")
+done
+
+# The base test case with the shared drop decisions, ahead of its SCENARIO section
+conf=$(mktemp)
+trap 'rm -f "$conf"' EXIT
+{
+	tr -d '\r' < "$base" | sed '/^SCENARIO:/,$d'
+	echo "TEXT_LOG: 0"
+	echo "MSGCOUNT_LOG: 0"
+	echo "DROP_BY_LINK: 1"
+	tr -d '\r' < "$base" | sed -n '/^SCENARIO:/,$p'
+} > "$conf"
+
+opts=(-j "$jobs" -o "$outdir" -c "$conf")
+if [ -n "$timelimit" ]; then
+	opts+=(-t "$timelimit")
+fi
+if [ -n "$memlimit" ]; then
+	opts+=(-m "$memlimit")
+fi
+./sweep.sh "${opts[@]}" "${args[@]}" > /dev/null || exit 1
+
+# Average the finished runs of every protocol over the seeds
+awk -F, '
+	NR == 1 {
+		for ( i = 1; i <= NF; i++ ) col[$i] = i
+		for ( i = 1; i < col["grade"]; i++ ) if ( $i != "PROTOCOL" && $i != "SEED" ) { keys = keys " " $i; keycols[++nkeys] = i }
+		print "PROTOCOL" keys " runs grade messages bytes cpu_s first_p50 full_p50 full_p99 missed false"
+		next
+	}
+	{
+		point = $col["PROTOCOL"]
+		for ( k = 1; k <= nkeys; k++ ) point = point " " $keycols[k]
+		if ( !(point in runs) ) { order[++npoints] = point; runs[point] = 0 }
+		if ( $col["status"] != "ok" ) next
+		runs[point]++
+		split($col["grade"], g, "/"); score[point] += g[1]; scoremax[point] += g[2]
+		msgs[point] += $col["messages"]; bytes[point] += $col["bytes"]; cpu[point] += $col["cpu_s"]
+		if ( $col["first_p50"] != "-" ) { first[point] += $col["first_p50"]; nfirst[point]++ }
+		if ( $col["full_p50"] != "-" ) { full50[point] += $col["full_p50"]; full99[point] += $col["full_p99"]; nfull[point]++ }
+		missed[point] += $col["missed"]; falses[point] += $col["false"]
+	}
+	function mean(sum, n, fmt) { return n ? sprintf(fmt, sum / n) : "-" }
+	END {
+		for ( p = 1; p <= npoints; p++ ) {
+			point = order[p]; n = runs[point]
+			if ( !n ) { print point, 0, "- - - - - - - - -"; continue }
+			print point, n, score[point] "/" scoremax[point], mean(msgs[point], n, "%.0f"), mean(bytes[point], n, "%.0f"),
+				mean(cpu[point], n, "%.3f"), mean(first[point], nfirst[point], "%.1f"), mean(full50[point], nfull[point], "%.1f"),
+				mean(full99[point], nfull[point], "%.1f"), missed[point], falses[point]
+		}
+	}
+' "$outdir/results.csv" > "$outdir/rows"
+
+# Align the columns
+awk '
+	NR == FNR { for ( i = 1; i <= NF; i++ ) if ( length($i) > w[i] ) w[i] = length($i); next }
+	{ for ( i = 1; i < NF; i++ ) printf "%-*s  ", w[i], $i; print $NF }
+' "$outdir/rows" "$outdir/rows" > "$outdir/compare.txt"
+rm -f "$outdir/rows"
+
+cat "$outdir/compare.txt"
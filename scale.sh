@@ -0,0 +1,74 @@
+#!/usr/bin/env bash
+
+#**********************
+#*
+#* Progam Name: MP1. Membership Protocol.
+#*
+#* Current file: scale.sh
+#* About this file: Scaling benchmark script.
+#*
+#***********************
+
+# Runs All to All, Gossip and SWIM on groups of 10 to 10000 nodes with fixed seeds and writes the
+# wall time per tick, traffic, peak RSS and detection quality of every run to <outdir>/results.csv,
+# and as an aligned table to <outdir>/results.txt.
+#
+#   ./scale.sh [-j jobs] [-o outdir] [-t seconds] [-m MB] [KEY=v1,v2,... ...]
+#
+# Every node joins at tick 0, 1% of them (at least one) crash at tick 100 and the run ends at
+# tick 300, without text logs. The grid is PROTOCOL=AllToAll,Gossip,SWIM NODES=10,100,1000,10000
+# SEED=1,2,3; a key given on the command line replaces its default or adds a dimension, as in
+# sweep.sh, which runs the grid. Runs go one at a time unless -j says otherwise, so that they do
+# not compete for cores. A run is stopped after -t seconds (1800 by default) and limited to -m MB
+# of address space (4096 by default): the sizes a protocol cannot reach show up with status
+# timeout or failed instead of holding up the others.
+
+cd "$(dirname "$0")"
+
+jobs=1
+outdir=scale-out
+timelimit=1800
+memlimit=4096
+
+while getopts "j:o:t:m:" opt; do
+	case $opt in
+		j) jobs=$OPTARG ;;
+		o) outdir=$OPTARG ;;
+		t) timelimit=$OPTARG ;;
+		m) memlimit=$OPTARG ;;
+		*) echo "usage: $0 [-j jobs] [-o outdir] [-t seconds] [-m MB] [KEY=v1,v2,... ...]"; exit 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+# Default grid, then the command line keys in their order
+keys=(PROTOCOL NODES SEED)
+declare -A grid=([PROTOCOL]=AllToAll,Gossip,SWIM [NODES]=10,100,1000,10000 [SEED]=1,2,3)
+for arg in "$@"; do
+	key=${arg%%=*}
+	if [ -z "${grid[$key]+set}" ]; then
+		keys+=("$key")
+	fi
+	grid[$key]=${arg#*=}
+done
+args=()
+for key in "${keys[@]}"; do
+	args+=("$key=${grid[$key]}")
+done
+
+base=$(mktemp)
+trap 'rm -f "$base"' EXIT
+cat > "$base" <<CONF
+MAX_NNB: 10
+SINGLE_FAILURE: 1
+DROP_MSG: 0
+MSG_DROP_PROB: 0
+TOTAL_TIME: 300
+TEXT_LOG: 0
+MSGCOUNT_LOG: 0
+SCENARIO:
+0 JOIN all
+100 CRASH random:1%
+CONF
+
+./sweep.sh -j "$jobs" -o "$outdir" -c "$base" -t "$timelimit" -m "$memlimit" "${args[@]}"
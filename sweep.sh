@@ -0,0 +1,324 @@
+#!/usr/bin/env bash
+
+#**********************
+#*
+#* Progam Name: MP1. Membership Protocol.
+#*
+#* Current file: sweep.sh
+#* About this file: Parameter sweep script.
+#*
+#***********************
+
+# Runs every point of a parameter grid, several at a time, and writes one results table with the
+# oracle's grade, traffic, detection latencies and wall time of every run.
+#
+#   ./sweep.sh [-j jobs] [-o outdir] [-c base.conf] [-k] [-t seconds] [-m MB] KEY=v1,v2,... ...
+#
+# Grid keys:
+#   PROTOCOL   SWIM, Gossip or AllToAll (default SWIM)
+#   NODES      cluster size (MAX_NNB)
+#   DROP       message drop probability, 0 turns dropping off
+#   FANOUT     FORWARD_PINGERS for SWIM, NGOSSIPS for Gossip
+#   TPING, TFAIL, TREMOVE, FORWARD_PINGERS, NGOSSIPS
+#              protocol constants, every combination gets its own build
+#   any other KEY is written to the test case as "KEY: value" (SEED, SINGLE_FAILURE, THREADS, ...)
+#
+# Without -c the base test case is singlefailure.conf. A protocol constant the protocol does
+# not have is shown as "-" and does not multiply the runs.
+#
+# Every run gets its own directory under <outdir>/runs (its logs are deleted unless -k is given,
+# detection.log and infection.log are kept), the table goes to <outdir>/results.txt and, with
+# commas between the fields, to <outdir>/results.csv. -t stops a run after that many seconds of
+# wall time and -m limits its address space to that many MB; status is ok, timeout or failed
+# (out of memory or crashed), and the other fields of a run that did not finish are "-".
+# Detection latencies come from the oracle: first is the time from a failure to the first node
+# removing the failed node, full to the last live node doing so; missed counts failures still
+# not fully detected at the end. false is the number of times a live node was removed and
+# false_p50/false_p99 how long it stayed removed. join_p50/join_p99 are the ticks until every
+# other live node had a joined node in its list, join_missed the joins that never got that far
+# (the per-event curves are in infection.log). complete and stale are the shares of the live
+# nodes the lists of the live nodes held and of their entries that were of nodes down, and
+# msg_rate the messages per live node and tick, all from MEASURE_FROM on. mem_total is the
+# peak of the bytes the simulator accounts for, mem_node the most a single node held.
+# quiescent is the tick a run with QUIESCENCE=1 stopped at, "-" if it ran to the end. cpu_s is
+# the user and system time of the run, ms_tick the wall time per tick and rss_kb the peak RSS of
+# the run.
+
+cd "$(dirname "$0")"
+
+jobs=$(nproc 2>/dev/null || echo 2)
+outdir=sweep-out
+base=""
+keeplogs=0
+timelimit=""
+memlimit=""
+
+while getopts "j:o:c:kt:m:" opt; do
+	case $opt in
+		j) jobs=$OPTARG ;;
+		o) outdir=$OPTARG ;;
+		c) base=$OPTARG ;;
+		k) keeplogs=1 ;;
+		t) timelimit=$OPTARG ;;
+		m) memlimit=$OPTARG ;;
+		*) echo "usage: $0 [-j jobs] [-o outdir] [-c base.conf] [-k] [-t seconds] [-m MB] KEY=v1,v2,... ..."; exit 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+macros="TPING TFAIL TREMOVE FORWARD_PINGERS NGOSSIPS FANOUT"
+
+function is_macro () {
+	local m
+	for m in $macros; do
+		if [ "$m" == "$1" ]; then
+			return 0
+		fi
+	done
+	return 1
+}
+
+function tree_of () {
+	case $1 in
+		SWIM) echo "SWIM" ;;
+		Gossip) echo "Gossip" ;;
+		AllToAll|"All To All") echo "All To All" ;;
+		*) return 1 ;;
+	esac
+}
+
+# Grid keys and values, in command line order; PROTOCOL always comes first
+keys=(PROTOCOL)
+values=(SWIM)
+for arg in "$@"; do
+	key=${arg%%=*}
+	if [ "$key" == "$arg" ] || [ -z "${arg#*=}" ]; then
+		echo "Bad grid argument $arg"
+		exit 1
+	fi
+	if [ "$key" == "PROTOCOL" ]; then
+		values[0]=${arg#*=}
+	else
+		keys+=("$key")
+		values+=("${arg#*=}")
+	fi
+done
+
+for p in ${values[0]//,/ }; do
+	if ! tree_of "$p" > /dev/null; then
+		echo "Unknown protocol $p"
+		exit 1
+	fi
+done
+
+rm -rf "$outdir"
+mkdir -p "$outdir/runs" "$outdir/build"
+outdir=$(cd "$outdir" && pwd)
+
+if [ -z "$base" ]; then
+	base="SWIM/testcases/singlefailure.conf"
+fi
+if [ ! -e "$base" ]; then
+	echo "Base test case $base not found"
+	exit 1
+fi
+
+# Expand the grid into one line of KEY=value words per point
+points=("")
+for k in "${!keys[@]}"; do
+	next=()
+	for point in "${points[@]}"; do
+		for v in ${values[$k]//,/ }; do
+			next+=("$point ${keys[$k]}=$v")
+		done
+	done
+	points=("${next[@]}")
+done
+
+# Resolve every point to a build variant and a test case; constants the protocol
+# does not have become "-" and the duplicate points they create are dropped
+declare -A seen variants
+npoints=0
+for point in "${points[@]}"; do
+	resolved=""
+	defines=""
+	for word in $point; do
+		key=${word%%=*}
+		val=${word#*=}
+		if [ "$key" == "PROTOCOL" ]; then
+			tree=$(tree_of "$val")
+		elif is_macro "$key"; then
+			name=$key
+			if [ "$key" == "FANOUT" ]; then
+				case $tree in
+					SWIM) name=FORWARD_PINGERS ;;
+					Gossip) name=NGOSSIPS ;;
+					*) name="" ;;
+				esac
+			fi
+			if [ -n "$name" ] && grep -q "#define $name " "$tree/MP1Node.h"; then
+				defines="$defines -D$name=$val"
+			else
+				val="-"
+			fi
+		fi
+		resolved="$resolved $key=$val"
+	done
+	if [ -n "${seen[$resolved]}" ]; then
+		continue
+	fi
+	seen[$resolved]=1
+
+	variant="$tree|$defines"
+	if [ -z "${variants[$variant]}" ]; then
+		variants[$variant]=${#variants[@]}
+	fi
+
+	run="$outdir/runs/$npoints"
+	mkdir -p "$run"
+	echo "$resolved" > "$run/point"
+	echo "${variants[$variant]}" > "$run/variant"
+	npoints=$((npoints + 1))
+done
+
+# Build every variant once
+for variant in "${!variants[@]}"; do
+	tree=${variant%%|*}
+	defines=${variant#*|}
+	dir="$outdir/build/${variants[$variant]}"
+	mkdir -p "$dir"
+	cp "$tree"/*.cpp "$tree"/*.h "$tree"/Makefile "$dir"
+	echo "Building $tree$defines"
+	if ! make -C "$dir" -j"$jobs" EMUL="$PWD/Emulator" DEFINES="$defines" > "$dir/make.log" 2>&1; then
+		echo "Build of $tree$defines failed, see $dir/make.log"
+		exit 1
+	fi
+done
+
+# Write the test case of a run: the four fixed lines, the optional settings of the base test
+# case, the grid settings (later lines win) and the SCENARIO section of the base test case
+function write_conf () {
+	local run=$1 word key val
+	local nnb=$(sed -n 's/^MAX_NNB: *//p' "$base" | tr -d '\r')
+	local single=$(sed -n 's/^SINGLE_FAILURE: *//p' "$base" | tr -d '\r')
+	local dropmsg=$(sed -n 's/^DROP_MSG: *//p' "$base" | tr -d '\r')
+	local prob=$(sed -n 's/^MSG_DROP_PROB: *//p' "$base" | tr -d '\r')
+	local extra=""
+
+	for word in $(cat "$run/point"); do
+		key=${word%%=*}
+		val=${word#*=}
+		case $key in
+			PROTOCOL) ;;
+			NODES|MAX_NNB) nnb=$val ;;
+			SINGLE_FAILURE) single=$val ;;
+			DROP|MSG_DROP_PROB)
+				prob=$val
+				if awk "BEGIN { exit !($val > 0) }"; then dropmsg=1; else dropmsg=0; fi ;;
+			DROP_MSG) dropmsg=$val ;;
+			*) if ! is_macro "$key"; then extra="$extra$key: $val\n"; fi ;;
+		esac
+	done
+
+	{
+		echo "MAX_NNB: $nnb"
+		echo "SINGLE_FAILURE: $single"
+		echo "DROP_MSG: $dropmsg"
+		echo "MSG_DROP_PROB: $prob"
+		tail -n +5 "$base" | tr -d '\r' | sed '/^SCENARIO:/,$d'
+		printf "$extra"
+		tail -n +5 "$base" | tr -d '\r' | sed -n '/^SCENARIO:/,$p'
+	} > "$run/test.conf"
+}
+
+# Print the named fields of one "<name>: n=.. p50=.. ..." line of the oracle, "-" for the missing
+function stat_of () {
+	local line=$(grep "^$2: " "$1/out.txt") field val out=""
+	for field in $3; do
+		val=$(echo "$line" | sed -n "s/.* $field=\([0-9]*\).*/\1/p")
+		out="$out ${val:--}"
+	done
+	echo $out
+}
+
+# Run one point in its own directory and leave its row of the table in <run>/row
+function run_point () {
+	local run=$1
+	local bin="$outdir/build/$(cat "$run/variant")/Application"
+
+	write_conf "$run"
+	(
+		cd "$run"
+		if [ -n "$memlimit" ]; then
+			ulimit -v $((memlimit * 1024))
+		fi
+		if [ -n "$timelimit" ]; then
+			timeout "$timelimit" "$bin" test.conf > out.txt 2>&1
+		else
+			"$bin" test.conf > out.txt 2>&1
+		fi
+	)
+	local code=$? status=ok
+	if [ $code -eq 124 ]; then
+		status=timeout
+	elif [ $code -ne 0 ]; then
+		status=failed
+	fi
+
+	local summary=$(grep "^Ran " "$run/out.txt")
+	local wall=$(echo "$summary" | sed -n 's/.* in \([0-9.]*\) s .*/\1/p')
+	local cpu=$(echo "$summary" | sed -n 's/.*, cpu \([0-9.]*\) s$/\1/p')
+	local msgs=$(echo "$summary" | sed -n 's/.*, \([0-9]*\) messages.*/\1/p')
+	local bytes=$(echo "$summary" | sed -n 's/.*messages (\([0-9]*\) bytes).*/\1/p')
+	local ticktime=$(echo "$summary" | sed -n 's/^Ran [0-9]* nodes for \([0-9]*\) ticks in \([0-9.]*\) s .*/\1 \2/p' | awk '$1 > 0 { printf "%.3f", 1000 * $2 / $1 }')
+	local rss=$(echo "$summary" | sed -n 's/.*peak RSS \([0-9]*\) KB.*/\1/p')
+	# Total score of the in-process oracle, as Grader.sh counts it
+	local grade=$(sed -n 's/^Grade \([0-9]*\/[0-9]*\)$/\1/p' "$run/out.txt")
+
+	# Detection summary of the oracle
+	local first=$(stat_of "$run" "First detection" "p50 p95 p99")
+	local full=$(stat_of "$run" "Full detection" "p50 p95 p99")
+	local false=$(stat_of "$run" "False removals" "n p50 p99")
+	local join=$(stat_of "$run" "Join spread to all" "p50 p99")
+	local joinmissed=$(sed -n 's/^Join events: [0-9]*, never known to all: \([0-9]*\)$/\1/p' "$run/out.txt")
+	local memory=$(stat_of "$run" "Memory peak" "total largest_node")
+	local failures=$(sed -n 's/^Failures: \([0-9]*\), not fully detected: \([0-9]*\)$/\1 \2/p' "$run/out.txt")
+	local views=$(sed -n 's/^Views from time=[0-9]*: complete=\([0-9.]*\) stale=\([0-9.]*\)$/\1 \2/p' "$run/out.txt")
+	local rate=$(sed -n 's/^Messages from time=[0-9]*: \([0-9.]*\) per .*/\1/p' "$run/out.txt")
+	local quiescent=$(sed -n 's/^Quiescent at time=\([0-9]*\) .*/\1/p' "$run/out.txt")
+
+	local word row=""
+	for word in $(cat "$run/point"); do
+		row="$row ${word#*=}"
+	done
+	echo "$row ${grade:--} ${msgs:--} ${bytes:--} ${failures:-- -} $first $full $false $join ${joinmissed:--} ${views:-- -} ${rate:--} $memory ${quiescent:--} ${wall:--} ${cpu:--} ${ticktime:--} ${rss:--} $status" > "$run/row"
+	if [ $keeplogs -eq 0 ]; then
+		rm -f "$run/dbg.log" "$run/msgcount.log" "$run/stats.log"
+	fi
+}
+
+echo "Running $npoints points, $jobs at a time"
+for (( i = 0; i < npoints; i++ )); do
+	while [ "$(jobs -rp | wc -l)" -ge "$jobs" ]; do
+		wait -n
+	done
+	run_point "$outdir/runs/$i" &
+done
+wait
+
+{
+	echo "${keys[*]} grade messages bytes failures missed first_p50 first_p95 first_p99 full_p50 full_p95 full_p99 false false_p50 false_p99 join_p50 join_p99 join_missed complete stale msg_rate mem_total mem_node quiescent wall_s cpu_s ms_tick rss_kb status"
+	for (( i = 0; i < npoints; i++ )); do
+		cat "$outdir/runs/$i/row"
+	done
+} > "$outdir/rows"
+
+# Align the columns
+awk '
+	NR == FNR { for ( i = 1; i <= NF; i++ ) if ( length($i) > w[i] ) w[i] = length($i); next }
+	{ for ( i = 1; i < NF; i++ ) printf "%-*s  ", w[i], $i; print $NF }
+' "$outdir/rows" "$outdir/rows" > "$outdir/results.txt"
+awk -v OFS=, '{ $1 = $1; print }' "$outdir/rows" > "$outdir/results.csv"
+rm -f "$outdir/rows"
+
+cat "$outdir/results.txt"